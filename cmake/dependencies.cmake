@@ -11,3 +11,10 @@ include(${CPM_FILEPATH})
 CPMAddPackage("gh:google/googletest#release-1.12.1")
 CPMAddPackage("gh:neargye/magic_enum#v0.8.1")
 CPMAddPackage("gh:fmtlib/fmt#8.1.1")
+
+CPMAddPackage(
+  NAME benchmark
+  GITHUB_REPOSITORY google/benchmark
+  VERSION 1.7.1
+  OPTIONS "BENCHMARK_ENABLE_TESTING OFF" "BENCHMARK_ENABLE_INSTALL OFF"
+)
@@ -0,0 +1,59 @@
+#ifndef MCC_CORPUS_HPP
+#define MCC_CORPUS_HPP
+
+#include "sample.hpp"
+#include <fmt/format.h>
+#include <string>
+
+namespace mcc {
+
+// Synthetic sources are generated up to <size> bytes, every corpus ends with an endline
+constexpr size_t CORPUS_SIZE = 1 << 20;
+
+inline auto corpus_var_c() -> std::string {
+  return std::string{SAMPLE_VAR_C};
+}
+
+// Translation unit made of the sample concatenated over and over
+inline auto corpus_unit(size_t size = CORPUS_SIZE) -> std::string {
+  std::string src{};
+  while (src.size() < size) src += SAMPLE_VAR_C;
+  return src;
+}
+
+inline auto corpus_comments(size_t size = CORPUS_SIZE) -> std::string {
+  std::string src{};
+
+  for (size_t n = 0; src.size() < size; n++) {
+    src += fmt::format("/*\n * Block comment {} describing the next declaration at length\n */\n", n);
+    src += fmt::format("// Line comment {} with some trailing words \\\n   continued\n", n);
+    src += fmt::format("int value_{} = {};\n", n, n);
+  }
+
+  return src;
+}
+
+inline auto corpus_strings(size_t size = CORPUS_SIZE) -> std::string {
+  std::string src{};
+
+  for (size_t n = 0; src.size() < size; n++) {
+    src += fmt::format("puts(\"string {} with \\\"escaped\\\" quotes and a newline\\n\");\n", n);
+    src += fmt::format("printf(L\"wide string %d of a longer format to scan\", {});\n", n);
+  }
+
+  return src;
+}
+
+inline auto corpus_numbers(size_t size = CORPUS_SIZE) -> std::string {
+  std::string src{};
+
+  for (size_t n = 0; src.size() < size; n++) {
+    src += fmt::format("x = {} + {}.{}e{} - 0x{:X} * {}.5;\n", n, n, n % 97, n % 7, n, n % 13);
+  }
+
+  return src;
+}
+
+}  // namespace mcc
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef MCC_LEXER_BENCH_HPP
+#define MCC_LEXER_BENCH_HPP
+
+#include "corpus.hpp"
+#include "scan/lexer.hpp"
+#include "scan/parallel_lexer.hpp"
+#include "scan/stream_lexer.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdio>
+
+namespace mcc {
+
+// Reports tokens/s as items_per_second and MB/s as bytes_per_second
+static void lexer_tokenize(benchmark::State &state, std::string src) {
+  size_t tokens = 0;
+
+  for (auto _ : state) {
+    Lexer lexer{src};
+
+    for (Token token = lexer.tokenize(); token.trait != End; token = lexer.tokenize()) {
+      benchmark::DoNotOptimize(token);
+      tokens++;
+    }
+  }
+
+  state.SetItemsProcessed(tokens);
+  state.SetBytesProcessed(state.iterations() * src.size());
+  state.counters["tokens"] = static_cast<f64>(tokens) / state.iterations();
+}
+
+// Whole source tokenized at once into a structure of arrays buffer
+static void lexer_tokenize_all(benchmark::State &state, std::string src) {
+  size_t tokens = 0;
+
+  for (auto _ : state) {
+    TokenBuffer buffer = Lexer{src}.tokenize_all();
+    benchmark::DoNotOptimize(buffer.traits().data());
+    tokens += buffer.size();
+  }
+
+  state.SetItemsProcessed(tokens);
+  state.SetBytesProcessed(state.iterations() * src.size());
+}
+
+// Whole source tokenized on state.range(0) threads
+static void lexer_tokenize_parallel(benchmark::State &state, std::string src) {
+  size_t tokens = 0;
+
+  for (auto _ : state) {
+    TokenBuffer buffer = tokenize_parallel(src, syntax_ansi(), state.range(0));
+    benchmark::DoNotOptimize(buffer.traits().data());
+    tokens += buffer.size();
+  }
+
+  state.SetItemsProcessed(tokens);
+  state.SetBytesProcessed(state.iterations() * src.size());
+}
+
+// Same as lexer_tokenize with the source read back in chunks from a temporary file
+static void lexer_stream(benchmark::State &state, std::string src) {
+  FILE *file = tmpfile();
+  fwrite(src.data(), 1, src.size(), file);
+  size_t tokens = 0;
+
+  for (auto _ : state) {
+    rewind(file);
+    StreamLexer lexer{fileno(file), syntax_ansi(), static_cast<size_t>(state.range(0))};
+
+    for (Token token = lexer.tokenize(); token.trait != End; token = lexer.tokenize()) {
+      benchmark::DoNotOptimize(token);
+      tokens++;
+    }
+  }
+
+  fclose(file);
+  state.SetItemsProcessed(tokens);
+  state.SetBytesProcessed(state.iterations() * src.size());
+}
+
+BENCHMARK_CAPTURE(lexer_tokenize, var_c, corpus_var_c());
+BENCHMARK_CAPTURE(lexer_tokenize, comments, corpus_comments());
+BENCHMARK_CAPTURE(lexer_tokenize, strings, corpus_strings());
+BENCHMARK_CAPTURE(lexer_tokenize, numbers, corpus_numbers());
+BENCHMARK_CAPTURE(lexer_tokenize, unit, corpus_unit());
+BENCHMARK_CAPTURE(lexer_tokenize, unit_large, corpus_unit(CORPUS_SIZE * 16));
+BENCHMARK_CAPTURE(lexer_tokenize_all, unit, corpus_unit());
+BENCHMARK_CAPTURE(lexer_tokenize_parallel, unit_large, corpus_unit(CORPUS_SIZE * 16))
+  ->RangeMultiplier(2)
+  ->Range(1, 8)
+  ->UseRealTime();
+BENCHMARK_CAPTURE(lexer_stream, unit, corpus_unit())->Arg(4096)->Arg(STREAM_CHUNK_SIZE);
+
+}  // namespace mcc
+
+#endif
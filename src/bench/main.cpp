@@ -0,0 +1,12 @@
+#include "lexer_bench.hpp"
+#include "regex_bench.hpp"
+#include <benchmark/benchmark.h>
+
+// Machine-readable results: mcc-bench --benchmark_format=json --benchmark_out=<file>
+int main(mcc::i32 argc, char **argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
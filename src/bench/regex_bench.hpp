@@ -0,0 +1,119 @@
+#ifndef MCC_REGEX_BENCH_HPP
+#define MCC_REGEX_BENCH_HPP
+
+#include "lorem_ipsum.hpp"
+#include "regex/regex.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+
+namespace mcc::regex {
+
+// Every position of <expr> is submitted to the regex, as the lexer would do for each token
+static auto match_all(const Regex &regex, std::string_view expr) -> size_t {
+  size_t matches = 0;
+
+  for (size_t index = 0; index < expr.size(); index++) {
+    matches += regex.match(expr.substr(index)) ? 1 : 0;
+  }
+
+  return matches;
+}
+
+static void regex_construct(benchmark::State &state, std::string_view src) {
+  for (auto _ : state) {
+    Regex regex{src};
+    benchmark::DoNotOptimize(regex.head());
+  }
+}
+
+static void regex_match(benchmark::State &state, std::string_view src) {
+  Regex regex{src};
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(match_all(regex, LOREM_IPSUM));
+  }
+
+  state.SetBytesProcessed(state.iterations() * LOREM_IPSUM.size());
+}
+
+// Input of <n> times <pattern>, the fitted complexity tells how the match time grows with <n>
+static void regex_adversarial(benchmark::State &state, std::string_view src, std::string pattern) {
+  Regex regex{src};
+  std::string expr{};
+
+  for (i64 n = 0; n < state.range(0); n++) expr += pattern;
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(regex.match(expr));
+  }
+
+  state.SetComplexityN(state.range(0));
+}
+
+// Same as regex_adversarial but the regex is submitted at every position of the input
+static void regex_adversarial_scan(
+  benchmark::State &state, std::string_view src, std::string pattern) {
+  Regex regex{src};
+  std::string expr{};
+
+  for (i64 n = 0; n < state.range(0); n++) expr += pattern;
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(match_all(regex, expr));
+  }
+
+  state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK_CAPTURE(regex_construct, text, "'lorem'");
+BENCHMARK_CAPTURE(regex_construct, string, "'L'? Q {{{'\\'^}|^} ~ /{Q|'\n'}} ? {Q|'\n'}");
+BENCHMARK_CAPTURE(
+  regex_construct,
+  integer,
+  "{'0b'|'0B' [0-1]+} | {'0x'|'0X' [0-9]|[a-f]|[A-F]+} | {[0-9]+ {'e'|'E' {'+'|'-'}? [0-9]+}?} a*");
+
+BENCHMARK_CAPTURE(regex_match, text, "'dolor'");
+BENCHMARK_CAPTURE(regex_match, set, "a+");
+BENCHMARK_CAPTURE(regex_match, range, "[a-z]+");
+BENCHMARK_CAPTURE(regex_match, not, "{!_}+");
+BENCHMARK_CAPTURE(regex_match, dash, "a+ /{'.'|','}");
+BENCHMARK_CAPTURE(regex_match, or, "'lorem'|'ipsum'|'dolor'|'sit'|'amet'");
+BENCHMARK_CAPTURE(regex_match, star, "a* _*");
+BENCHMARK_CAPTURE(regex_match, plus, "{a|','}+");
+BENCHMARK_CAPTURE(regex_match, wave, "^~'.'");
+
+// Alternatives and nested repetitions matching the same characters backtrack through every split
+BENCHMARK_CAPTURE(regex_adversarial, or_plus, "{'a'|'a'}+ 'b'", "a")
+  ->DenseRange(4, 20, 4)
+  ->Complexity();
+BENCHMARK_CAPTURE(regex_adversarial, nested_plus, "{'a'+}+ 'b'", "a")
+  ->DenseRange(4, 20, 4)
+  ->Complexity();
+BENCHMARK_CAPTURE(regex_adversarial, or_wave, "{'a'|'aa'}~'b'", "a")
+  ->DenseRange(4, 20, 4)
+  ->Complexity();
+BENCHMARK_CAPTURE(regex_adversarial, wave, "^~'b'", "a")
+  ->RangeMultiplier(4)
+  ->Range(1 << 8, 1 << 16)
+  ->Complexity();
+
+// Lookaheads nested in a lookahead are submitted again by the sub-search of every position
+BENCHMARK_CAPTURE(regex_adversarial, nested_lookahead, "{!{^* /{'a'* 'b'}}}+", "a")
+  ->RangeMultiplier(2)
+  ->Range(1 << 5, 1 << 8)
+  ->Complexity();
+
+// Unterminated comments and strings rescan the rest of the input from every position, the patterns
+// never close them: the comment has no <*/> and the quotes of the string are all escaped
+BENCHMARK_CAPTURE(regex_adversarial_scan, comment, "'/*' ^~ '*/'", "/*a")
+  ->RangeMultiplier(4)
+  ->Range(1 << 6, 1 << 12)
+  ->Complexity();
+BENCHMARK_CAPTURE(regex_adversarial_scan, string, "Q {{{'\\'^}|^} ~ /{Q|'\n'}} ? {Q|'\n'}", "\"\\")
+  ->RangeMultiplier(4)
+  ->Range(1 << 6, 1 << 12)
+  ->Complexity();
+
+}  // namespace mcc::regex
+
+#endif
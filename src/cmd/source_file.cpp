@@ -0,0 +1,91 @@
+#include "source_file.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mcc {
+
+SourceFile::SourceFile(std::string_view filepath) : m_data(nullptr), m_size(0), m_capacity(0) {
+  std::string path{filepath};
+  int fd = open(path.c_str(), O_RDONLY);
+
+  if (fd < 0) {
+    throw Exception{"fs exception", "can't read file from '{}': {}", path, std::strerror(errno)};
+  }
+
+  struct stat status {};
+  if (fstat(fd, &status) < 0) {
+    close(fd);
+    throw Exception{"fs exception", "can't stat file '{}': {}", path, std::strerror(errno)};
+  }
+
+  // NOTE: pipes and character devices such as /dev/stdin have no size to map, they are read up to
+  // their end and copied in the mapping instead
+  bool regular = S_ISREG(status.st_mode);
+  std::string stream{};
+
+  for (char buffer[64 * 1024]; !regular;) {
+    ssize_t count = read(fd, buffer, sizeof(buffer));
+
+    if (count < 0 and errno == EINTR) continue;
+    if (count < 0) {
+      int error = errno;
+      close(fd);
+      throw Exception{"fs exception", "can't read file from '{}': {}", path, std::strerror(error)};
+    }
+    if (count == 0) break;
+    stream.append(buffer, count);
+  }
+
+  size_t size = regular ? status.st_size : stream.size();
+  size_t page = sysconf(_SC_PAGESIZE);
+
+  // NOTE: one more byte is reserved for the padding endline, when the file fills its last page the
+  // padding lands on the anonymous page following the file mapping
+  m_capacity = (size + 1 + page - 1) / page * page;
+  void *data = mmap(nullptr, m_capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+  int error = errno;
+
+  if (data != MAP_FAILED and regular and size != 0) {
+    if (mmap(data, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+      error = errno;
+      munmap(data, m_capacity);
+      data = MAP_FAILED;
+    }
+  } else if (data != MAP_FAILED) {
+    std::memcpy(data, stream.data(), size);
+  }
+
+  close(fd);
+
+  if (data == MAP_FAILED) {
+    throw Exception{"fs exception", "can't map file '{}': {}", path, std::strerror(error)};
+  }
+
+  m_data = static_cast<char *>(data);
+  m_size = size;
+
+  // Writing the padding only copies the last page of a private mapping
+  if (m_size == 0 or m_data[m_size - 1] != '\n') {
+    m_data[m_size++] = '\n';
+  }
+
+  if (mprotect(m_data, m_capacity, PROT_READ) < 0) {
+    int error = errno;
+    munmap(m_data, m_capacity);
+    m_data = nullptr;
+    throw Exception{"fs exception", "can't protect file '{}': {}", path, std::strerror(error)};
+  }
+
+  madvise(m_data, m_capacity, MADV_SEQUENTIAL);
+}
+
+SourceFile::~SourceFile() {
+  if (m_data) munmap(m_data, m_capacity);
+}
+
+}  // namespace mcc
@@ -0,0 +1,32 @@
+#ifndef MCC_SOURCE_FILE_HPP
+#define MCC_SOURCE_FILE_HPP
+
+#include <mcc.hpp>
+#include <string_view>
+
+namespace mcc {
+
+// Read-only private mapping of a source file, the lexer and the ast views point directly into it.
+// The endline character required by the lexer is written past the end of the file in the mapping
+// instead of copying the source.
+class SourceFile {
+public:
+  SourceFile(std::string_view filepath);
+  ~SourceFile();
+
+  SourceFile(const SourceFile &) = delete;
+  auto operator=(const SourceFile &) -> SourceFile & = delete;
+
+  auto src() const -> std::string_view {
+    return {m_data, m_size};
+  }
+
+private:
+  char *m_data;
+  size_t m_size;
+  size_t m_capacity;
+};
+
+}  // namespace mcc
+
+#endif
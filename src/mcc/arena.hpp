@@ -0,0 +1,103 @@
+#ifndef MCC_ARENA_HPP
+#define MCC_ARENA_HPP
+
+#include "mcc.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mcc {
+
+constexpr size_t ARENA_BLOCK_SIZE = 64 * 1024;
+
+// Bump allocator constructing objects in place inside large blocks that are all freed at once,
+// only the objects with a non-trivial destructor are recorded to be destroyed with the arena
+class Arena {
+  struct Destructor {
+    void *object;
+    void (*destroy)(void *object);
+  };
+
+public:
+  Arena() : m_blocks(), m_cursor(nullptr), m_space(0), m_destructors() {}
+
+  // NOTE: the moved arena starts a new block on its next allocation
+  Arena(Arena &&arena) :
+    m_blocks(std::move(arena.m_blocks)),
+    m_cursor(std::exchange(arena.m_cursor, nullptr)),
+    m_space(std::exchange(arena.m_space, 0)),
+    m_destructors(std::move(arena.m_destructors)) {
+    arena.m_blocks.clear();
+    arena.m_destructors.clear();
+  }
+
+  Arena(const Arena &) = delete;
+  auto operator=(const Arena &) -> Arena & = delete;
+
+  ~Arena() {
+    // NOTE: objects are destroyed in the reverse order of their construction
+    for (auto it = m_destructors.rbegin(); it != m_destructors.rend(); it++) {
+      it->destroy(it->object);
+    }
+  }
+
+  template<typename T, typename... Args>
+  auto make(Args &&...args) -> T * {
+    T *object = new (allocate(sizeof(T), alignof(T))) T{std::forward<Args>(args)...};
+
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      m_destructors.push_back({object, [](void *object) {
+                                 std::destroy_at(static_cast<T *>(object));
+                               }});
+    }
+
+    return object;
+  }
+
+  // Copies <items> in a span of the arena sized to their count, e.g. the children of a node
+  template<typename T>
+  auto copy(std::span<const T> items) -> std::span<T> {
+    static_assert(std::is_trivially_copyable_v<T> and std::is_trivially_destructible_v<T>);
+
+    if (items.empty()) {
+      return {};
+    }
+
+    T *data = static_cast<T *>(allocate(items.size_bytes(), alignof(T)));
+    std::uninitialized_copy(items.begin(), items.end(), data);
+    return {data, items.size()};
+  }
+
+  auto allocate(size_t size, size_t align) -> void * {
+    void *cursor = m_cursor;
+
+    if (!m_cursor or !std::align(align, size, cursor, m_space)) {
+      size_t capacity = std::max(ARENA_BLOCK_SIZE, size + align);
+      cursor = m_blocks.emplace_back(std::make_unique<std::byte[]>(capacity)).get();
+      m_space = capacity;
+      std::align(align, size, cursor, m_space);
+    }
+
+    m_cursor = static_cast<std::byte *>(cursor) + size;
+    m_space -= size;
+    return cursor;
+  }
+
+  auto blocks() const -> size_t {
+    return m_blocks.size();
+  }
+
+private:
+  std::vector<std::unique_ptr<std::byte[]>> m_blocks;
+  std::byte *m_cursor;
+  size_t m_space;
+  std::vector<Destructor> m_destructors;
+};
+
+}  // namespace mcc
+
+#endif
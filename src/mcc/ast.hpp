@@ -1,40 +1,124 @@
 #ifndef MCC_AST_HPP
 #define MCC_AST_HPP
 
+#include "arena.hpp"
 #include "defn.hpp"
+#include "interner.hpp"
 #include "node.hpp"
-#include <unordered_map>
+#include <span>
+#include <utility>
 #include <vector>
 
 namespace mcc {
 
+// Nodes and definitions are constructed in the ast arena and freed all at once with the ast,
+// definitions are indexed by the symbol of their name
 class Ast {
 public:
-  ~Ast() {
-    for (auto node : m_nodes)
-      delete node;
-    for (auto defn : m_defn_map)
-      delete defn.second;
+  Ast() : m_parent(nullptr), m_base(0), m_scoped(false) {}
+
+  // Scope of the function bodies parsed apart from the declarations of <parent>, the names are
+  // looked up in <parent> without writing to it so that scopes can be filled concurrently. The
+  // scope symbols follow the ones of <parent> and its definitions are kept until clear_locals(),
+  // the symbols of concurrent scopes overlap until their definitions are adopted by <parent>.
+  explicit Ast(const Ast *parent) :
+    m_parent(parent),
+    m_base(parent->m_base + parent->m_symbols.size() - 1),
+    m_scoped(true) {}
+
+  template<typename T, typename... Args>
+  auto push(Args &&...args) -> T * {
+    return m_arena.make<T>(std::forward<Args>(args)...);
   }
 
+  // Variable-length children of a node, stored in the arena to fit their count
   template<typename T>
-  auto push(T *node) -> T * {
-    return m_nodes.emplace_back(static_cast<Node *>(node));
+  auto span(std::span<T> items) -> std::span<T> {
+    return m_arena.copy<T>(items);
   }
 
-  template<typename T>
-  auto defn(T *defn) -> T * {
-    return m_defn_map.try_emplace(defn->name(), defn).second;
+  template<typename T, typename... Args>
+  auto defn(Args &&...args) -> T * {
+    T *defn = m_arena.make<T>(std::forward<Args>(args)...);
+    defn->m_symbol = intern(defn->name());
+
+    if (m_scoped) {
+      m_locals.push_back(defn);
+      return defn;
+    }
+
+    if (m_defns.size() <= defn->m_symbol) {
+      m_defns.resize(defn->m_symbol + 1, nullptr);
+    }
+    if (!m_defns[defn->m_symbol]) {
+      m_defns[defn->m_symbol] = defn;
+    }
+
+    return defn;
+  }
+
+  auto intern(std::string_view name) -> u32 {
+    if (u32 symbol = m_parent ? m_parent->lookup(name) : SYMBOL_NONE) {
+      return symbol;
+    }
+    return m_base + m_symbols.intern(name);
+  }
+
+  auto find(u32 symbol) const -> Defn * {
+    // NOTE: a scope holds a few definitions, the latest one shadows the others
+    for (auto it = m_locals.rbegin(); it != m_locals.rend(); it++) {
+      if ((*it)->symbol() == symbol) return *it;
+    }
+
+    if (m_parent) {
+      return m_parent->find(symbol);
+    }
+    return symbol < m_defns.size() ? m_defns[symbol] : nullptr;
   }
 
   auto find(std::string_view name) const -> Defn * {
-    auto it = m_defn_map.find(name);
-    return it != m_defn_map.end() ? it->second : nullptr;
+    return find(lookup(name));
+  }
+
+  // Definitions that follow are local to the body being parsed until clear_locals(), as in a scope.
+  // The nodes of the body are kept in the ast arena.
+  auto open_locals() -> void {
+    m_scoped = true;
+  }
+
+  // Definitions of the body being parsed, they are dropped from the scope and returned
+  auto clear_locals() -> std::vector<Defn *> {
+    m_scoped = m_parent != nullptr;
+    return std::exchange(m_locals, {});
+  }
+
+  // Keeps the nodes of <scope> alive with the ast once its bodies are parsed
+  auto adopt(Ast &&scope) -> void {
+    m_scopes.push_back(std::move(scope.m_arena));
+  }
+
+  // Gives the <locals> of a scope their symbol in the ast, they are still not found by name
+  auto adopt(std::span<Defn *const> locals) -> void {
+    for (Defn *defn : locals) defn->m_symbol = intern(defn->name());
   }
 
 private:
-  std::vector<Node *> m_nodes;
-  std::unordered_map<std::string_view, Defn *> m_defn_map;
+  auto lookup(std::string_view name) const -> u32 {
+    if (u32 symbol = m_parent ? m_parent->lookup(name) : SYMBOL_NONE) {
+      return symbol;
+    }
+    u32 symbol = m_symbols.find(name);
+    return symbol != SYMBOL_NONE ? m_base + symbol : SYMBOL_NONE;
+  }
+
+  Arena m_arena;
+  Interner m_symbols;
+  std::vector<Defn *> m_defns;
+  std::vector<Defn *> m_locals;
+  std::vector<Arena> m_scopes;
+  const Ast *m_parent;
+  u32 m_base;
+  bool m_scoped;
 };
 
 }  // namespace mcc
@@ -4,13 +4,12 @@
 namespace mcc {
 
   // TODO: support multiline code exceptions
-auto code_exception(std::string_view name, std::string_view desc, std::string_view src, Token token)
+auto code_exception(std::string_view name, std::string_view desc, const SourceMap &map, Token token)
   -> Exception {
-  auto line = std::count(src.begin(), token.src.begin(), '\n');
-  auto rbegin = std::find(token.src.rend(), src.rend(), '\n');
-  auto begin = std::max(rbegin.base(), src.begin());
-  auto end = std::find(token.src.end(), src.end(), '\n');
-  auto cursor = token.src.begin() - begin + 1;
+  auto [line, column] = map.locate(token);
+  auto begin = token.src.begin() - column;
+  auto end = std::find(token.src.end(), map.src().end(), '\n');
+  auto cursor = column + 1;
 
   return Exception{
     "source code exception",
@@ -28,4 +27,10 @@ auto code_exception(std::string_view name, std::string_view desc, std::string_vi
   };
 }
 
+auto code_exception(
+  std::string_view name, std::string_view desc, std::string_view src, Token token, size_t line)
+  -> Exception {
+  return code_exception(name, desc, SourceMap{src, line}, token);
+}
+
 }  // namespace mcc
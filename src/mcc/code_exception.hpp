@@ -2,6 +2,7 @@
 #define MCC_CODE_EXCEPTION_HPP
 
 #include "mcc.hpp"
+#include "scan/source_map.hpp"
 #include "scan/token.hpp"
 
 namespace mcc {
@@ -14,7 +15,12 @@ private:
   
 };
 
-auto code_exception(std::string_view name, std::string_view desc, std::string_view src, Token token)
+auto code_exception(std::string_view name, std::string_view desc, const SourceMap &map, Token token)
+  -> Exception;
+
+// <line> is the number of the line <src> starts on, when it is only a part of the source
+auto code_exception(
+  std::string_view name, std::string_view desc, std::string_view src, Token token, size_t line = 0)
   -> Exception;
 
 }  // namespace mcc
@@ -1,10 +1,9 @@
 #ifndef MCC_DEFN_HPP
 #define MCC_DEFN_HPP
 
-#include "limits.hpp"
 #include "scan/token.hpp"
 #include "type.hpp"
-#include <array>
+#include <span>
 #include <string_view>
 
 namespace mcc {
@@ -13,7 +12,7 @@ enum class DefnKind { Var, Func, Struct, EnumConstant, StringConstant, Primitive
 
 class Defn {
 public:
-  Defn(std::string_view name) : m_name(name) {}
+  Defn(std::string_view name) : m_name(name), m_symbol(0) {}
   virtual ~Defn() = default;
 
   virtual auto kind() const -> DefnKind = 0;
@@ -22,8 +21,15 @@ public:
     return m_name;
   }
 
+  auto symbol() const -> u32 {
+    return m_symbol;
+  }
+
 private:
+  friend class Ast;
+
   std::string_view m_name;
+  u32 m_symbol;
 };
 
 class Var : public Defn {
@@ -40,7 +46,7 @@ private:
 
 class Func : public Defn {
 public:
-  Func(Type type, std::string_view name, auto params) :
+  Func(Type type, std::string_view name, std::span<Var *> params) :
     Defn(name),
     m_type(type),
     m_params(params) {}
@@ -49,21 +55,29 @@ public:
     return DefnKind::Func;
   }
 
+  auto params() const -> std::span<Var *> {
+    return m_params;
+  }
+
 private:
   Type m_type;
-  std::array<Var *, max::func_args> m_params;
+  std::span<Var *> m_params;
 };
 
 class Struct : public Defn {
 private:
-  Struct(std::string_view name, auto members) : Defn(name), m_members(members) {}
+  Struct(std::string_view name, std::span<Var *> members) : Defn(name), m_members(members) {}
 
   auto kind() const -> DefnKind override {
     return DefnKind::Struct;
   }
 
+  auto members() const -> std::span<Var *> {
+    return m_members;
+  }
+
 private:
-  std::array<Var *, max::struct_members> m_members;
+  std::span<Var *> m_members;
 };
 
 class EnumConstant : public Defn {
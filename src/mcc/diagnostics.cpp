@@ -0,0 +1,43 @@
+#include "diagnostics.hpp"
+#include "code_exception.hpp"
+#include <algorithm>
+#include <tuple>
+
+namespace mcc {
+
+auto Diagnostic::exception(const SourceMap &map) const -> Exception {
+  return code_exception(name, desc, map, token);
+}
+
+auto Diagnostics::sort() -> void {
+  auto key = [](const Diagnostic &diagnostic) {
+    return std::tuple{diagnostic.token.src.data(), diagnostic.token.src.size(), diagnostic.desc};
+  };
+
+  auto less = [&](const Diagnostic &a, const Diagnostic &b) -> bool {
+    return key(a) < key(b);
+  };
+  auto equal = [&](const Diagnostic &a, const Diagnostic &b) -> bool {
+    return key(a) == key(b);
+  };
+
+  std::stable_sort(m_diagnostics.begin(), m_diagnostics.end(), less);
+  m_diagnostics.erase(std::unique(m_diagnostics.begin(), m_diagnostics.end(), equal),
+                      m_diagnostics.end());
+}
+
+auto Diagnostics::format(const SourceMap &map) const -> std::string {
+  std::string buffer{};
+
+  for (const Diagnostic &diagnostic : m_diagnostics) {
+    buffer += fmt::format("{}: {}\n", diagnostic.name, diagnostic.exception(map).what());
+  }
+
+  if (m_dropped) {
+    buffer += fmt::format("{} more diagnostics were dropped\n", m_dropped);
+  }
+
+  return buffer;
+}
+
+}  // namespace mcc
@@ -0,0 +1,82 @@
+#ifndef MCC_DIAGNOSTICS_HPP
+#define MCC_DIAGNOSTICS_HPP
+
+#include "scan/source_map.hpp"
+#include "scan/token.hpp"
+#include <vector>
+
+namespace mcc {
+
+constexpr size_t DIAGNOSTICS_CAPACITY = 256;
+
+// Error found in the source, <name> and <desc> refer to static strings so that nothing is
+// formatted until the diagnostic is reported
+struct Diagnostic {
+  auto exception(const SourceMap &map) const -> Exception;
+
+  std::string_view name;
+  std::string_view desc;
+  Token token;
+};
+
+// Errors recorded by the lexer and the parser while they recover from them, the buffer is
+// allocated once and the diagnostics past its capacity are only counted
+class Diagnostics {
+public:
+  Diagnostics() : m_diagnostics(), m_dropped(0) {
+    m_diagnostics.reserve(DIAGNOSTICS_CAPACITY);
+  }
+
+  auto report(std::string_view name, std::string_view desc, Token token) -> void {
+    if (m_diagnostics.size() < DIAGNOSTICS_CAPACITY) {
+      m_diagnostics.push_back(Diagnostic{name, desc, token});
+    } else {
+      m_dropped++;
+    }
+  }
+
+  auto append(const Diagnostics &diagnostics) -> void {
+    for (const Diagnostic &diagnostic : diagnostics.m_diagnostics) {
+      report(diagnostic.name, diagnostic.desc, diagnostic.token);
+    }
+    m_dropped += diagnostics.m_dropped;
+  }
+
+  // Orders the diagnostics as they appear in the source and drops the ones reported twice
+  auto sort() -> void;
+
+  // Messages of the recorded diagnostics in the order they were found
+  auto format(const SourceMap &map) const -> std::string;
+
+  auto operator[](size_t n) const -> const Diagnostic & {
+    return m_diagnostics[n];
+  }
+
+  auto begin() const {
+    return m_diagnostics.begin();
+  }
+
+  auto end() const {
+    return m_diagnostics.end();
+  }
+
+  auto size() const -> size_t {
+    return m_diagnostics.size();
+  }
+
+  auto empty() const -> bool {
+    return m_diagnostics.empty();
+  }
+
+  auto dropped() const -> size_t {
+    return m_dropped;
+  }
+
+private:
+  std::vector<Diagnostic> m_diagnostics;
+  size_t m_dropped;
+};
+
+}  // namespace mcc
+
+#endif
@@ -1,11 +1,9 @@
 #ifndef MCC_EXPR_HPP
 #define MCC_EXPR_HPP
 
-#include "limits.hpp"
 #include "node.hpp"
 #include "scan/token.hpp"
 #include "type.hpp"
-#include <array>
 #include <span>
 
 namespace mcc {
@@ -81,11 +79,15 @@ private:
 
 class InvokeExpr : public Expr {
 public:
-  InvokeExpr(struct Func *func, auto args) : m_func(func), m_args(args) {}
+  InvokeExpr(struct Func *func, std::span<Expr *> args) : m_func(func), m_args(args) {}
+
+  auto args() const -> std::span<Expr *> {
+    return m_args;
+  }
 
 private:
   struct Func *m_func;
-  std::array<Expr *, max::func_args> m_args;
+  std::span<Expr *> m_args;
 };
 
 class TernaryExpr : public Expr {
@@ -0,0 +1,104 @@
+#ifndef MCC_INTERNER_HPP
+#define MCC_INTERNER_HPP
+
+#include "arena.hpp"
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+namespace mcc {
+
+// Symbol of the strings that were never interned, e.g. the tokens that are not identifiers
+constexpr u32 SYMBOL_NONE = 0;
+
+// Unique copies of the identifiers stored in an arena, each string is given a dense symbol from 1
+// so that the definitions can be indexed by symbol instead of hashing names on each lookup. The
+// strings are found back from an open addressing table of symbols probed linearly.
+class Interner {
+public:
+  Interner() : m_arena(), m_strings{{}}, m_hashes{0}, m_slots(64, SYMBOL_NONE) {}
+
+  auto intern(std::string_view string) -> u32 {
+    u32 hash = hash_of(string);
+    size_t slot = probe(string, hash);
+
+    if (m_slots[slot] != SYMBOL_NONE) {
+      return m_slots[slot];
+    }
+
+    u32 symbol = m_strings.size();
+    m_strings.push_back(copy(string));
+    m_hashes.push_back(hash);
+    m_slots[slot] = symbol;
+
+    // NOTE: keeps the table at most half full so that probes stay short
+    if (m_strings.size() * 2 > m_slots.size()) {
+      grow();
+    }
+
+    return symbol;
+  }
+
+  auto find(std::string_view string) const -> u32 {
+    return m_slots[probe(string, hash_of(string))];
+  }
+
+  auto operator[](u32 symbol) const -> std::string_view {
+    return m_strings[symbol];
+  }
+
+  // Interned strings including the empty string of SYMBOL_NONE
+  auto size() const -> size_t {
+    return m_strings.size();
+  }
+
+private:
+  // FNV-1a, identifiers are too short for a wider hash to pay off
+  static auto hash_of(std::string_view string) -> u32 {
+    u32 hash = 2166136261;
+    for (char c : string) {
+      hash = (hash ^ static_cast<u8>(c)) * 16777619;
+    }
+    return hash;
+  }
+
+  // Slot holding <string> or the empty slot where it would be inserted
+  auto probe(std::string_view string, u32 hash) const -> size_t {
+    size_t mask = m_slots.size() - 1;
+
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+      u32 symbol = m_slots[slot];
+      if (symbol == SYMBOL_NONE or (m_hashes[symbol] == hash and m_strings[symbol] == string)) {
+        return slot;
+      }
+    }
+  }
+
+  auto copy(std::string_view string) -> std::string_view {
+    char *data = static_cast<char *>(m_arena.allocate(string.size(), 1));
+    std::memcpy(data, string.data(), string.size());
+    return {data, string.size()};
+  }
+
+  void grow() {
+    std::vector<u32> slots(m_slots.size() * 2, SYMBOL_NONE);
+    size_t mask = slots.size() - 1;
+
+    for (u32 symbol = 1; symbol < m_strings.size(); symbol++) {
+      size_t slot = m_hashes[symbol] & mask;
+      while (slots[slot] != SYMBOL_NONE) slot = (slot + 1) & mask;
+      slots[slot] = symbol;
+    }
+
+    m_slots = std::move(slots);
+  }
+
+  Arena m_arena;
+  std::vector<std::string_view> m_strings;
+  std::vector<u32> m_hashes;
+  std::vector<u32> m_slots;
+};
+
+}  // namespace mcc
+
+#endif
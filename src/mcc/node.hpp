@@ -5,10 +5,15 @@ namespace mcc {
 
 // TODO: define virtual functions for code generation
 // e.g: virtual auto asm_x86(AsmContext *ctx) const -> AsmContext *;
+// NOTE: nodes without code generation yet leave the contexts untouched
 class Node {
 public:
-  virtual auto graph(class GraphContext &ctx) -> class GraphContext & = 0;
-  virtual auto asm_x86(class AsmContext &ctx) -> class AsmContext   & = 0;
+  virtual auto graph(class GraphContext &ctx) -> class GraphContext & {
+    return ctx;
+  }
+  virtual auto asm_x86(class AsmContext &ctx) -> class AsmContext & {
+    return ctx;
+  }
 };
 
 }  // namespace mcc
@@ -1,68 +1,171 @@
 #include "parser.hpp"
 #include "defn.hpp"
 #include "expr.hpp"
+#include "limits.hpp"
 #include "stmt.hpp"
+#include <atomic>
+#include <functional>
+#include <thread>
 
 namespace mcc {
 
-Parser::Parser(Lexer lexer) : m_lexer(lexer) {
+Parser::Parser(Lexer lexer, bool lazy) : m_lexer(lexer), m_lazy(lazy) {
   // Define basic types in the ast
-  m_ast.defn(new auto(Primitive::defn_void()));
-  m_ast.defn(new auto(Primitive::defn_char()));
-  m_ast.defn(new auto(Primitive::defn_short()));
-  m_ast.defn(new auto(Primitive::defn_int()));
-  m_ast.defn(new auto(Primitive::defn_long()));
-  m_ast.defn(new auto(Primitive::defn_float()));
-  m_ast.defn(new auto(Primitive::defn_double()));
-  m_ast.defn(new auto(Primitive::defn_signed()));
-  m_ast.defn(new auto(Primitive::defn_unsigned()));
+  m_ast.defn<Primitive>(Primitive::defn_void());
+  m_ast.defn<Primitive>(Primitive::defn_char());
+  m_ast.defn<Primitive>(Primitive::defn_short());
+  m_ast.defn<Primitive>(Primitive::defn_int());
+  m_ast.defn<Primitive>(Primitive::defn_long());
+  m_ast.defn<Primitive>(Primitive::defn_float());
+  m_ast.defn<Primitive>(Primitive::defn_double());
+  m_ast.defn<Primitive>(Primitive::defn_signed());
+  m_ast.defn<Primitive>(Primitive::defn_unsigned());
 }
 
+// Parser of the skipped bodies on a worker thread, the names of <ast> are only read
+Parser::Parser(Lexer lexer, const Ast &ast) : m_ast(&ast), m_lexer(lexer), m_lazy(false) {}
+
+// Errors are reported as they are found and the parser carries on from the next statement, so that
+// a single run reports every error of the source. They are sorted by position once parsed.
 auto Parser::parse() -> Ast & {
-  parse_stmt();
+  while (token_peek().trait != End) {
+    parse_recover();
+  }
+
+  m_diagnostics.sort();
   return m_ast;
 }
 
+// Parses the body of a function skipped by a lazy parser, the body is parsed once and kept by the
+// statement. The parser is left where it was so bodies can be parsed in any order.
+auto Parser::parse_body(FuncStmt *stmt) -> CompoundStmt * {
+  if (!stmt->lazy()) {
+    return stmt->m_body;
+  }
+
+  // NOTE: a single body is parsed in the ast arena, a scope would hold a block for a few nodes
+  Lexer lexer = m_lexer;
+  TokenRing tokens = m_tokens;
+  Token last = m_last;
+
+  parse_local(stmt);
+
+  m_lexer = lexer;
+  m_tokens = tokens;
+  m_last = last;
+
+  // NOTE: the errors of the body were reported once already when it was skipped
+  m_diagnostics.sort();
+  return stmt->m_body;
+}
+
+// Parses the bodies skipped by a lazy parser across <threads> workers, or the hardware threads when
+// zero. The ast is the same whatever the number of threads.
+auto Parser::parse_bodies(u32 threads) -> void {
+  threads = threads ? threads : std::max(std::thread::hardware_concurrency(), 1u);
+  parse_scopes(m_bodies, threads);
+}
+
+// Each worker parses bodies into its own scope of the ast, its definitions are local to the body
+// being parsed and its nodes are adopted by the ast once every body is parsed. The calling thread
+// is the first worker.
+auto Parser::parse_scopes(std::span<FuncStmt *const> stmts, u32 threads) -> void {
+  std::vector<Parser> parsers{};
+  std::vector<std::thread> workers{};
+  std::vector<std::vector<Defn *>> locals(stmts.size());
+  std::atomic<size_t> next = 0;
+
+  parsers.reserve(std::min<size_t>(threads, stmts.size()));
+  for (size_t n = 0; n < parsers.capacity(); n++) {
+    parsers.push_back(Parser{m_lexer, m_ast});
+  }
+
+  auto work = [&](Parser &parser) {
+    for (size_t n = next++; n < stmts.size(); n = next++) {
+      if (stmts[n]->lazy()) locals[n] = parser.parse_local(stmts[n]);
+    }
+  };
+
+  for (size_t n = 1; n < parsers.size(); n++) {
+    workers.emplace_back(work, std::ref(parsers[n]));
+  }
+  if (!parsers.empty()) {
+    work(parsers.front());
+  }
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+
+  // NOTE: the symbols of the locals are given in the order of the bodies, not of their workers
+  for (std::span<Defn *const> defns : locals) {
+    m_ast.adopt(defns);
+  }
+  for (Parser &parser : parsers) {
+    m_diagnostics.append(parser.m_diagnostics);
+    m_ast.adopt(std::move(parser.m_ast));
+  }
+
+  // NOTE: the errors of the bodies were reported once already when they were skipped
+  m_diagnostics.sort();
+}
+
+// Parses a skipped body with its definitions local to it, the definitions are returned
+auto Parser::parse_local(FuncStmt *stmt) -> std::vector<Defn *> {
+  m_lexer.seek(stmt->m_range.src.data());
+  m_tokens = TokenRing{};
+  m_ast.open_locals();
+  stmt->m_body = parse_compound_stmt();
+
+  return m_ast.clear_locals();
+}
+
 auto Parser::parse_type() -> Type {
   using enum DefnKind;
 
   for (Type type{};;) {
-    if (auto name = token_maybe(CsIdentifier | GpPrimitive)) {
-      // NOTE: Too far, the token can be the name of the identifier
-      // We have to check past the type defn because there is no order
-      // in the type declaration, e.g: const int a -> int const a;
-      if (type.defn != nullptr) {
-        return type;
-      }
-      type.defn = m_ast.find(name.src);
+    auto peek = token_peek();
 
-      if (type.defn and type.defn->kind() != Primitive and type.defn->kind() != Struct) {
-        throw exception("identifier does not refer to a defined type", name);
-      }
+    // NOTE: Too far, the token can be the name of the identifier
+    // We have to check past the type defn because there is no order
+    // in the type declaration, e.g: const int a -> int const a;
+    if (type.defn != nullptr and peek.trait & CsIdentifier) {
+      return type;
+    }
+
+    // NOTE: an identifier that does not name a type starts an expression or names the declaration
+    if (peek.trait & CsIdentifier) {
+      Defn *defn = m_ast.find(peek.symbol);
+      if (!defn or (defn->kind() != Primitive and defn->kind() != Struct)) return type;
+    }
+
+    if (auto name = token_maybe(CsIdentifier | GpPrimitive)) {
+      type.defn = m_ast.find(name.symbol);
     } else if (auto mode = token_maybe(GpModifier)) {
       // TODO: choose to define type mode as a bitfield or as a compound token
+      if (type.mode & mode.trait & TYPE_MASK) {
+        report("repeated type modifier in declaration", mode);
+      }
       type.mode |= (mode.trait & TYPE_MASK);
 
-      if (type.mode & mode.trait) {
-        throw exception("repeated type modifier in declaration", mode);
-      }
       if (type.mode & Type::Signed and type.mode & Type::Unsigned) {
-        throw exception("cannot combine type modifiers of discordant signedness", mode);
+        report("cannot combine type modifiers of discordant signedness", mode);
       }
     } else {
-      // NOTE: free the node queue if the token
-      if (type.ok()) token_peek_erase();
       return type;
     }
   }
 }
 
 auto Parser::parse_defn() -> Stmt * {
-  auto peek = token_peek();
-
   // var-defn | func-defn
   if (auto type = parse_type(); type.ok()) {
     auto name = token_expect(CsIdentifier);
+
+    // NOTE: nothing is defined without a name, the statement is skipped by parse_recover()
+    if (!name) {
+      return {};
+    }
+
     auto next = token_peek();
 
     if (next.trait != ParenBegin) {
@@ -76,98 +179,155 @@ auto Parser::parse_defn() -> Stmt * {
 }
 
 // TODO: write an intermediate func to compose expressions
+// NOTE: a parsed operand is passed as <stack>, it is the left side of the operator that follows
 auto Parser::parse_expr(Expr *stack) -> Expr * {
+  if (stack) {
+    //                 _
+    // :monkey_jam: @('-')@
+    //             _-*| |._-
+    if (auto increment_op = token_maybe(Increment | Decrement)) {
+      return parse_expr(m_ast.push<UnaryExpr>(Order::Post, stack, increment_op));
+    }
+
+    if (auto binary_op = token_maybe(GpBinaryOp)) {
+      return m_ast.push<BinaryExpr>(stack, parse_expr(), binary_op);
+    }
+
+    return stack;
+  }
+
   if (auto id = token_maybe(CsIdentifier)) {
-    auto defn = m_ast.find(id.src);
+    auto defn = m_ast.find(id.symbol);
     auto next = token_peek();
 
+    // NOTE: the expression is kept without a definition to carry on parsing
     if (!defn) {
-      throw exception("unknown indentifier in expression", id);  // ?:J
+      report("unknown indentifier in expression", id);  // ?:J
     }
 
     // NOTE: try to invoke the definition
-    if (next.trait & ParenBegin) {
-      if (defn->kind() != DefnKind::Func) {
-        throw exception("cannot invoke non-function expression", id);
+    if (next.trait == ParenBegin) {
+      Func *func = nullptr;
+
+      if (defn and defn->kind() == DefnKind::Func) {
+        func = static_cast<Func *>(defn);
+      } else if (defn) {
+        report("cannot invoke non-function expression", id);
       }
-      std::array<Expr *, max::func_args> args{0};
-      return m_ast.push(new InvokeExpr{static_cast<Func *>(defn), parse_argument(args, 0)});
+      std::array<Expr *, max::func_args> args{};
+      return parse_expr(m_ast.push<InvokeExpr>(func, m_ast.span(parse_argument(args, 0))));
     }
 
-    auto expr = m_ast.push(new IdExpr{m_ast.find(id.src)});
+    return parse_expr(m_ast.push<IdExpr>(defn));
   }
 
   if (auto string = token_maybe(String)) {
-    m_ast.defn(new StringConstant{string});
-    return m_ast.push(new ConstantExpr{string});
+    m_ast.defn<StringConstant>(string);
+    return parse_expr(m_ast.push<ConstantExpr>(string));
   }
 
   if (auto constant = token_maybe(CsConstant)) {
-    return m_ast.push(new ConstantExpr{constant});
-  }
-
-  if (auto sign = token_maybe(Add | Sub); sign.ok() and !stack) {
-    return m_ast.push(new UnaryExpr{Order::Prev, parse_expr(), sign});
-  }
-
-  if (auto binary_op = token_maybe(CsOperator)) {
-    return m_ast.push(new BinaryExpr{stack, parse_expr(), binary_op});
-  }
-
-  //                 _
-  // :monkey_jam: @('-')@
-  //             _-*| |._-
-  if (auto increment_op = token_maybe(Increment | Decrement)) {
-    if (!stack) {
-      return m_ast.push(new UnaryExpr{Order::Prev, stack, increment_op});
-    } else {
-      return m_ast.push(new UnaryExpr{Order::Post, parse_expr(), increment_op});
-    }
+    return parse_expr(m_ast.push<ConstantExpr>(constant));
   }
 
+  // NOTE: checked before the operators since the parenthesis is an operator as well
   // cast-expr | nested-expr
-  if (token_maybe(ParenBegin)) {
+  if (auto mark = m_tokens.mark(); token_maybe(ParenBegin)) {
     if (auto type = parse_type(); type.ok()) {
-      return m_ast.push(new CastExpr{type, parse_expr()});
+      m_tokens.release(mark);
+      token_expect(ParenClose);
+      return m_ast.push<CastExpr>(type, parse_expr());
     } else {
       // TODO: nested-expr case L:.|
+      m_tokens.rewind(mark);
     }
+  } else {
+    m_tokens.release(mark);
+  }
+
+  if (auto sign = token_maybe(Add | Sub)) {
+    return m_ast.push<UnaryExpr>(Order::Prev, parse_expr(), sign);
   }
 
-  throw exception("expected expression", token_next());
+  if (auto increment_op = token_maybe(Increment | Decrement)) {
+    return m_ast.push<UnaryExpr>(Order::Prev, parse_expr(), increment_op);
+  }
+
+  // NOTE: the token is left to the caller, it can be the delimiter of the statement
+  report("expected expression", token_peek());
+  return nullptr;
 }
 
-auto Parser::parse_stmt() -> Stmt * {
-  auto token = token_peek();
+// Parses a statement and skips to the end of it on an error, at least a token is consumed
+auto Parser::parse_recover() -> Stmt * {
+  size_t position = m_tokens.position();
+  size_t errors = m_diagnostics.size();
+  Stmt *stmt = parse_stmt();
 
-  if (auto type = parse_type(); type.ok()) {
-    return parse_defn();
+  if (m_tokens.position() == position) {
+    report("expected declaration", token_next());
+  }
+  // NOTE: a statement that reached its delimiter is skipped already
+  bool ended = m_last.trait == Semicolon or m_last.trait == CurlyClose;
+  if (m_diagnostics.size() != errors and !ended) {
+    token_sync();
   }
 
-  return {};
+  return stmt;
+}
+
+auto Parser::parse_stmt() -> Stmt * {
+  // NOTE: parse_type() only consumes the tokens of a type, nothing is consumed otherwise
+  return parse_defn();
 }
 
 auto Parser::parse_func(Type type, Token name) -> FuncStmt * {
-  auto params = std::array<Var *, max::func_args>{0};
-  auto func   = m_ast.defn(new Func{type, name.src, parse_param(params, 0)});
-  auto next   = token_peek();
+  auto params = std::array<Var *, max::func_args>{};
+  auto func   = m_ast.defn<Func>(type, name.src, m_ast.span(parse_param(params, 0)));
 
   if (token_maybe(Semicolon)) {
-    return m_ast.push(new FuncStmt{func, {}});
+    return m_ast.push<FuncStmt>(func, nullptr);
+  } else if (m_lazy) {
+    auto stmt = m_ast.push<FuncStmt>(func, nullptr, token_skip_body());
+    if (stmt->lazy()) m_bodies.push_back(stmt);
+    return stmt;
   } else {
-    return m_ast.push(new FuncStmt{func, parse_compound_stmt()});
+    // NOTE: the definitions of the body are local to it as when the body is skipped
+    m_ast.open_locals();
+    auto stmt = m_ast.push<FuncStmt>(func, parse_compound_stmt());
+    m_ast.clear_locals();
+    m_bodies.push_back(stmt);
+    return stmt;
+  }
+}
+
+auto Parser::parse_compound_stmt() -> CompoundStmt * {
+  auto open = token_expect(CurlyBegin);
+  auto body = std::vector<Stmt *>{};
+
+  while (token_peek().trait != CurlyClose and token_peek().trait != End) {
+    if (auto stmt = parse_recover()) body.push_back(stmt);
   }
+
+  return m_ast.push<CompoundStmt>(open, body, token_expect(CurlyClose));
 }
 
+// The parameters are gathered in <params> on the stack and copied to the ast once counted
 auto Parser::parse_param(std::span<Var *> params, size_t n) -> std::span<struct Var *> {
-  if (!n) {
-    token_expect(ParenBegin);
+  if (!n and token_expect(ParenBegin) and token_maybe(ParenClose)) {
+    return {};
   }
 
   // NOTE: Are anonymous parameters defined in the ansi standard ? Warning ?
   auto type = parse_type();
   auto name = token_maybe(CsIdentifier);
-  m_ast.push(new Var{type, name.ok() ? name.src : m_lexer.dummy_token().src});
+  auto var  = m_ast.push<Var>(type, name.ok() ? name.src : m_lexer.dummy_token().src);
+
+  if (n >= params.size()) {
+    report("too many parameters in function definition", name);
+    n = params.size() - 1;
+  }
+  params[n] = var;
 
   if (token_maybe(Comma)) {
     return parse_param(params, n + 1);
@@ -178,12 +338,12 @@ auto Parser::parse_param(std::span<Var *> params, size_t n) -> std::span<struct
 }
 
 auto Parser::parse_init(Type type, Token name) -> struct InitStmt * {
-  Var *var   = m_ast.defn(new Var{type, name.src});
+  Var *var   = m_ast.defn<Var>(type, name.src);
   Expr *expr = nullptr;
 
   if (auto assign = token_maybe(Assign)) {
     if (expr = parse_expr(); !expr) {
-      throw exception("expected expression after assignment", assign);
+      report("expected expression after assignment", assign);
     }
   }
 
@@ -193,16 +353,22 @@ auto Parser::parse_init(Type type, Token name) -> struct InitStmt * {
     token_expect(Semicolon);
   }
 
-  return m_ast.push(new InitStmt{var, expr});
+  return m_ast.push<InitStmt>(var, expr);
 }
 
 auto Parser::parse_argument(std::span<Expr *> args, size_t n) -> std::span<Expr *> {
-  if (!n) {
-    token_expect(ParenBegin);
+  if (!n and token_expect(ParenBegin) and token_maybe(ParenClose)) {
+    return {};
   }
 
   // NOTE: expression parsing should stop when encoutering a comma or a closing-parenthesis
-  args[n] = parse_expr();
+  auto expr = parse_expr();
+
+  if (n >= args.size()) {
+    report("too many arguments in function call", token_peek());
+    n = args.size() - 1;
+  }
+  args[n] = expr;
 
   if (token_maybe(Comma)) {
     return parse_argument(args, n + 1);
@@ -212,58 +378,91 @@ auto Parser::parse_argument(std::span<Expr *> args, size_t n) -> std::span<Expr
   }
 }
 
-auto Parser::token_next() -> Token {
-  if (!m_peek_deque.empty()) {
-    return token_peek_pop();
-  }
+// NOTE: the message is only formatted once the diagnostics are reported
+void Parser::report(std::string_view desc, Token token) {
+  m_diagnostics.report("parser exception", desc, token);
+}
 
-  return m_lexer.tokenize();
+auto Parser::token_next() -> Token {
+  token_peek();
+  return m_last = m_tokens.pop();
 }
 
+// The unexpected token is left to the caller as if the expected one was missing, the returned token
+// is not ok() then
 auto Parser::token_expect(u32 mask) -> Token {
-  auto token = token_next();
+  auto token = token_maybe(mask);
 
-  if (u32 type = trait_type(mask); !(token.trait & type)) {
-    throw exception("todo! type based error", token);
-  }
-
-  if (!(token.trait & mask)) {
-    throw exception("todo! mask based error", token);
+  if (!token) {
+    report("unexpected token", token);
   }
 
   return token;
 }
 
+// The matching token is consumed and returned ok(), it is left for the next parse otherwise
 auto Parser::token_maybe(u32 mask) -> Token {
-  auto token = token_peek_front();
+  auto token = token_peek();
 
-  if (!(token.trait & trait_type(mask)) or !(token.trait & mask)) {
-    token.trait &= ~OK_MASK;
+  if (!trait_match(token.trait, mask)) {
+    return token;
   }
 
+  m_last = m_tokens.pop();
+  token.trait |= OK_MASK;
   return token;
 }
 
-auto Parser::token_peek() -> Token {
-  return m_peek_deque.emplace_back(m_lexer.tokenize());
-}
+// Lexes up to the <n>th token following the cursor without consuming it, names are interned as
+// they are lexed so that definitions are found by symbol
+auto Parser::token_peek(size_t n) -> Token {
+  while (m_tokens.size() <= n) {
+    Token token = m_lexer.tokenize(m_diagnostics);
+
+    if (token.trait & (CsIdentifier | GpPrimitive)) {
+      token.symbol = m_ast.intern(token.src);
+    }
 
-void Parser::token_peek_erase() {
-  m_peek_deque.clear();
+    m_tokens.push(token);
+  }
+
+  return m_tokens[n];
 }
 
-auto Parser::token_peek_pop() -> Token {
-  Token token = token_peek_front();
-  m_peek_deque.pop_front();
-  return token;
+// Skips the tokens up to the end of the statement following an error, the closing brace of the
+// enclosing compound statement is left to it
+void Parser::token_sync() {
+  for (Token token = token_peek(); token.trait != End; token = token_peek()) {
+    if (token.trait == CurlyClose) break;
+    m_tokens.pop();
+    if (token.trait == Semicolon) break;
+  }
 }
 
-auto Parser::token_peek_front() -> Token {
-  if (!m_peek_deque.empty()) {
-    return token_peek();
+// Skips a compound statement by matching its braces, the tokens are lexed without being interned
+// since they are not parsed. Returns the tokens of the statement merged from brace to brace.
+// NOTE: the skipped statement is ended even when the lexer reported errors within it
+auto Parser::token_skip_body() -> Token {
+  auto open = token_expect(CurlyBegin);
+
+  if (!open) {
+    return open;
   }
 
-  return m_peek_deque.front();
+  for (size_t depth = 1;;) {
+    Token token = !m_tokens.empty() ? m_tokens.pop() : m_lexer.tokenize(m_diagnostics);
+
+    if (token.trait == End) {
+      report("unmatched curly bracket, missing <}> ending delimiter", open);
+      open.trait &= ~OK_MASK;
+      return m_last = open;
+    }
+    if (token.trait == CurlyBegin) depth++;
+    if (token.trait == CurlyClose and !--depth) {
+      m_last = token;
+      return open.merge(token);
+    }
+  }
 }
 
 }  // namespace mcc
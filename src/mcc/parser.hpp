@@ -2,21 +2,45 @@
 #define MCC_PARSER_HPP
 
 #include "ast.hpp"
+#include "diagnostics.hpp"
 #include "scan/lexer.hpp"
-#include <deque>
+#include "scan/token_ring.hpp"
 
 namespace mcc {
 
 class Parser {
 public:
-  Parser(Lexer lexer);
+  // A <lazy> parser only records the tokens of the function bodies, they are parsed on demand
+  Parser(Lexer lexer, bool lazy = false);
   auto parse() -> Ast &;
+  auto parse_body(struct FuncStmt *stmt) -> struct CompoundStmt *;
+  auto parse_bodies(u32 threads = 0) -> void;
+
+  // Errors found during parse(), the ast is only valid when there are none
+  auto diagnostics() const -> const Diagnostics & {
+    return m_diagnostics;
+  }
+
+  auto source_map() -> const SourceMap & {
+    return m_lexer.source_map();
+  }
+
+  // Functions defined with a body, the bodies are skipped by a lazy parse()
+  auto bodies() const -> std::span<struct FuncStmt *const> {
+    return m_bodies;
+  }
 
 private:
+  Parser(Lexer lexer, const Ast &ast);
+
+  auto parse_scopes(std::span<struct FuncStmt *const> stmts, u32 threads) -> void;
+  auto parse_local(struct FuncStmt *stmt) -> std::vector<struct Defn *>;
+
   auto parse_type() -> Type;
   auto parse_defn() -> struct Stmt *;
   auto parse_expr(struct Expr *stack = {}) -> struct Expr *;
   auto parse_stmt() -> struct Stmt *;
+  auto parse_recover() -> struct Stmt *;
 
   auto parse_func(Type type, Token name) -> struct FuncStmt *;
   auto parse_param(std::span<struct Var *> params, size_t n) -> std::span<struct Var *>;
@@ -28,17 +52,19 @@ private:
   auto token_next() -> Token;
   auto token_expect(u32 mask) -> Token;
   auto token_maybe(u32 mask) -> Token;
-  auto token_peek() -> Token;
-  void token_peek_erase();
-  auto token_peek_pop() -> Token;
-  auto token_peek_top() -> Token;
-  auto token_peek_front() -> Token;
+  auto token_peek(size_t n = 0) -> Token;
+  void token_sync();
+  auto token_skip_body() -> Token;
 
-  auto exception(std::string_view fmt, Token token, auto... args) -> Exception;
+  void report(std::string_view desc, Token token);
 
   Ast m_ast;
   Lexer m_lexer;
-  std::deque<Token> m_peek_deque;
+  TokenRing m_tokens;
+  Token m_last{};
+  Diagnostics m_diagnostics;
+  std::vector<struct FuncStmt *> m_bodies;
+  bool m_lazy;
 };
 
 }  // namespace mcc
@@ -0,0 +1,363 @@
+#include "dfa.hpp"
+#include "regex.hpp"
+#include <map>
+#include <optional>
+#include <set>
+
+namespace mcc::regex {
+
+constexpr u32 DFA_DEAD = 0;
+constexpr u32 DFA_START = 1;
+constexpr u32 DFA_EXIT = static_cast<u32>(-1);
+
+class Dfa::Builder {
+  // Position of a backtracking path inside a node of the <rule> head, <offset> counts the
+  // characters consumed by a text state and is set to DFA_EXIT once the state has been submitted
+  struct Thread {
+    u32 rule;
+    const Node *node;
+    u32 offset;
+
+    auto operator<=>(const Thread &) const = default;
+  };
+  using Threads = std::vector<Thread>;
+
+public:
+  Builder(Dfa &dfa) : m_dfa(dfa) {}
+
+  auto build() -> bool {
+    Threads start{};
+
+    for (u32 rule = 0; rule < m_dfa.m_heads.size(); rule++) {
+      const Node *head = m_dfa.m_heads[rule];
+
+      if (head and !collect(head)) {
+        return false;
+      }
+      if (head) start.push_back({rule, head, 0});
+    }
+
+    if (start.empty()) {
+      return false;
+    }
+
+    partition();
+    intern({});
+    intern(std::move(start));
+
+    std::vector<Edge> table{};
+
+    for (u32 id = 0; id < m_states.size(); id++) {
+      if (m_states.size() > DFA_CAPACITY) {
+        return false;
+      }
+
+      Threads threads = m_states[id];
+
+      for (u32 symbol = 0; symbol < m_dfa.m_width; symbol++) {
+        Threads consumers{};
+        u32 accept = 0;
+
+        m_visited.clear();
+        for (const Thread &thread : threads) {
+          if ((accept = close(thread, symbol, consumers))) break;
+        }
+
+        table.push_back({intern(step(consumers, symbol)), accept});
+      }
+    }
+
+    m_dfa.m_table = std::move(table);
+    return true;
+  }
+
+private:
+  auto eof() const -> u32 {
+    return m_dfa.m_width - 1;
+  }
+
+  // Gather the character predicates of every node reachable from <node>
+  auto collect(const Node *node) -> bool {
+    if (!m_nodes.insert(node).second) {
+      return true;
+    }
+
+    const State &state = node->state();
+
+    switch (state.option()) {
+    case Option::Any:
+    case Option::Set: {
+      m_sets[node] = state.charset();
+    } break;
+
+    case Option::Text: {
+      for (char c : std::get<Text>(state.variant()).content) {
+        m_predicates.push_back(Charset{}.set(static_cast<u8>(c)));
+      }
+    } break;
+
+    case Option::Not: {
+      auto set = lookahead(std::get<Not>(state.variant()).sequence);
+      if (!set) return false;
+      m_sets[node] = ~*set;
+    } break;
+
+    case Option::Dash: {
+      auto set = lookahead(std::get<Dash>(state.variant()).sequence);
+      if (!set) return false;
+      m_sets[node] = *set;
+    } break;
+
+    default: break;
+    }
+
+    if (m_sets.contains(node)) {
+      m_predicates.push_back(m_sets[node]);
+    }
+
+    for (const Node *edge : node->edges()) {
+      if (!collect(edge)) return false;
+    }
+
+    return true;
+  }
+
+  // Characters on which <sequence> matches, only when the outcome does not depend on anything
+  // past the next character
+  auto lookahead(const Node *sequence) -> std::optional<Charset> {
+    Charset set{};
+    std::set<const Node *> visited{};
+
+    if (!first(sequence, set, visited)) {
+      return std::nullopt;
+    }
+
+    return set;
+  }
+
+  auto first(const Node *node, Charset &set, std::set<const Node *> &visited) -> bool {
+    if (!visited.insert(node).second) {
+      return true;
+    }
+
+    const State &state = node->state();
+    Charset consumed{};
+
+    switch (state.option()) {
+    case Option::None: return true;
+    case Option::Dash: return false;
+
+    case Option::Epsilon: {
+      // NOTE: an empty match accepts any character
+      if (!node->branch()) set.set();
+
+      for (const Node *edge : node->edges()) {
+        if (!first(edge, set, visited)) return false;
+      }
+      return true;
+    }
+
+    case Option::Text: {
+      auto content = std::get<Text>(state.variant()).content;
+      if (content.size() != 1) return false;
+      consumed.set(static_cast<u8>(content[0]));
+    } break;
+
+    case Option::Not: {
+      auto inner = lookahead(std::get<Not>(state.variant()).sequence);
+      if (!inner) return false;
+      consumed = ~*inner;
+    } break;
+
+    default: {
+      consumed = state.charset();
+    } break;
+    }
+
+    std::set<const Node *> path{};
+    if (!nullable(node, path)) {
+      return false;
+    }
+
+    set |= consumed;
+    return true;
+  }
+
+  // Whether the exit of <node> reaches an accepting node through epsilon states only
+  auto nullable(const Node *node, std::set<const Node *> &visited) -> bool {
+    if (!node->branch()) {
+      return true;
+    }
+
+    visited.insert(node);
+
+    for (const Node *edge : node->edges()) {
+      if (edge->state().has(Option::Epsilon) and !visited.contains(edge)) {
+        if (nullable(edge, visited)) return true;
+      }
+    }
+
+    return false;
+  }
+
+  // Split the bytes into classes that no predicate can tell apart
+  void partition() {
+    std::array<u16, 256> &classes = m_dfa.m_classes;
+    classes.fill(0);
+
+    for (const Charset &predicate : m_predicates) {
+      std::map<std::pair<u16, bool>, u16> ids{};
+
+      for (u32 c = 0; c < classes.size(); c++) {
+        auto key = std::pair{classes[c], predicate[c]};
+        classes[c] = ids.try_emplace(key, ids.size()).first->second;
+      }
+    }
+
+    m_symbols.clear();
+    for (u32 c = 0; c < classes.size(); c++) {
+      if (classes[c] >= m_symbols.size()) m_symbols.push_back(c);
+    }
+
+    m_dfa.m_width = m_symbols.size() + 1;
+  }
+
+  // Follow the backtracking order from <thread> with <symbol> as the next character, collects the
+  // threads waiting for a character and returns the accepted rule + 1 when an accepting node is
+  // reached first, threads following an accept have a lower priority and are dropped
+  auto close(Thread thread, u32 symbol, Threads &consumers) -> u32 {
+    if (!m_visited.insert(thread).second) {
+      return 0;
+    }
+
+    auto [rule, node, offset] = thread;
+
+    if (offset == DFA_EXIT) {
+      if (!node->branch() and symbol == eof()) return rule + 1;
+
+      for (const Node *edge : node->edges()) {
+        if (u32 accept = close({rule, edge, 0}, symbol, consumers)) return accept;
+      }
+
+      return !node->branch() ? rule + 1 : 0;
+    }
+
+    const State &state = node->state();
+
+    switch (state.option()) {
+    case Option::Epsilon: return close({rule, node, DFA_EXIT}, symbol, consumers);
+    case Option::None: return 0;
+
+    case Option::Dash: {
+      if (symbol == eof() or !m_sets[node][m_symbols[symbol]]) return 0;
+      return close({rule, node, DFA_EXIT}, symbol, consumers);
+    }
+
+    case Option::Text: {
+      if (!std::get<Text>(state.variant()).content.empty()) break;
+      if (symbol == eof()) return 0;
+      return close({rule, node, DFA_EXIT}, symbol, consumers);
+    }
+
+    default: break;
+    }
+
+    consumers.push_back(thread);
+    return 0;
+  }
+
+  auto step(const Threads &consumers, u32 symbol) -> Threads {
+    Threads threads{};
+
+    if (symbol == eof()) {
+      return threads;
+    }
+
+    u8 c = m_symbols[symbol];
+
+    for (const auto &[rule, node, offset] : consumers) {
+      const State &state = node->state();
+
+      if (state.has(Option::Text)) {
+        auto content = std::get<Text>(state.variant()).content;
+
+        if (content[offset] == static_cast<char>(c)) {
+          threads.push_back({rule, node, offset + 1 < content.size() ? offset + 1 : DFA_EXIT});
+        }
+      } else if (m_sets[node][c]) {
+        threads.push_back({rule, node, DFA_EXIT});
+      }
+    }
+
+    return threads;
+  }
+
+  auto intern(Threads threads) -> u32 {
+    auto [it, inserted] = m_ids.try_emplace(threads, m_states.size());
+    if (inserted) m_states.push_back(std::move(threads));
+    return it->second;
+  }
+
+  Dfa &m_dfa;
+  std::set<const Node *> m_nodes;
+  std::map<const Node *, Charset> m_sets;
+  std::vector<Charset> m_predicates;
+  std::vector<u8> m_symbols;
+  std::set<Thread> m_visited;
+  std::map<Threads, u32> m_ids;
+  std::vector<Threads> m_states;
+};
+
+Dfa::Dfa(const Regex &regex) : Dfa(std::vector<const Node *>{regex.head()}) {}
+
+Dfa::Dfa(std::vector<const Node *> heads) :
+  m_heads(std::move(heads)),
+  m_classes(),
+  m_width(0),
+  m_table() {
+  Builder{*this}.build();
+}
+
+auto Dfa::submit(std::string_view expr, size_t index) const -> size_t {
+  return scan(expr, index).first;
+}
+
+// A <partial> expression is followed by input not read yet, npos() is returned as soon as the
+// outcome depends on a character past its end
+auto Dfa::scan(std::string_view expr, size_t index, bool partial) const
+  -> std::pair<size_t, u32> {
+  if (!compiled()) {
+    // NOTE: the node graphs may read up to the end of input, nothing is decided on a partial one
+    if (partial) return {npos(), 0};
+
+    for (u32 rule = 0; rule < m_heads.size(); rule++) {
+      const Node *head = m_heads[rule];
+      if (auto match = head ? head->submit(expr, index) : npos(); match != npos()) {
+        return {match, rule};
+      }
+    }
+    return {npos(), 0};
+  }
+
+  size_t match = npos();
+  u32 rule = 0;
+
+  for (u32 state = DFA_START; state != DFA_DEAD; index++) {
+    if (partial and index >= expr.size()) {
+      return {npos(), 0};
+    }
+
+    u32 symbol = index < expr.size() ? m_classes[static_cast<u8>(expr[index])] : m_width - 1;
+    const Edge &edge = m_table[state * m_width + symbol];
+
+    if (edge.accept) {
+      match = index;
+      rule = edge.accept - 1;
+    }
+    state = edge.next;
+  }
+
+  return {match, rule};
+}
+
+}  // namespace mcc::regex
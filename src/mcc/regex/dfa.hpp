@@ -0,0 +1,56 @@
+#ifndef MCC_REGEX_DFA_HPP
+#define MCC_REGEX_DFA_HPP
+
+#include "match.hpp"
+#include "node.hpp"
+#include <array>
+#include <vector>
+
+namespace mcc::regex {
+class Regex;
+
+constexpr size_t DFA_CAPACITY = 4096;
+
+// Table-driven automaton compiled from regex node graphs, each state is the ordered list of
+// threads the backtracking engine would try, so the first accepting thread keeps the priority of
+// Node::submit(). Heads are rules tried in order, the first rule matching wins as if each head was
+// submitted one after another. Lookaheads are determinized when they only depend on the next
+// character, the remaining patterns fall back to the node graphs.
+class Dfa {
+public:
+  struct Edge {
+    u32 next;
+    u32 accept;
+  };
+
+  Dfa(const Regex &regex);
+  Dfa(std::vector<const Node *> heads);
+
+  auto submit(std::string_view expr, size_t index) const -> size_t;
+  auto scan(std::string_view expr, size_t index, bool partial = false) const
+    -> std::pair<size_t, u32>;
+
+  auto match(std::string_view expr) const -> Match {
+    return Match{expr, submit(expr, 0)};
+  }
+
+  auto compiled() const -> bool {
+    return !m_table.empty();
+  }
+
+  auto size() const -> size_t {
+    return compiled() ? m_table.size() / m_width : 0;
+  }
+
+private:
+  class Builder;
+
+  std::vector<const Node *> m_heads;
+  std::array<u16, 256> m_classes;
+  u32 m_width;
+  std::vector<Edge> m_table;
+};
+
+}  // namespace mcc::regex
+
+#endif
@@ -34,7 +34,7 @@ struct formatter<Regex> {
       format_to(ctx.out(), R"("{}" [shape="none"]{})", start, '\n');
       format_to(ctx.out(), R"("{}" -> "{}" [label="{}"]{})", start, head_ptr, head_state, '\n');
 
-      for (const Node *node : regex.head()->members()) {
+      for (const Node *node : regex.members()) {
         format_to(ctx.out(), "{}", *node);
       }
     }
@@ -131,7 +131,12 @@ struct formatter<State> {
     }
 
     case Option::Set: {
-      auto set = std::get<Set>(state.variant()).content;
+      auto bitmap = std::get<Set>(state.variant()).bitmap;
+      std::string set{};
+
+      for (u32 c = 0; c < 256; c++) {
+        if (bitmap.test(c)) set.push_back(static_cast<char>(c));
+      }
 
       if (set.size() < 1) {
         return format_to(ctx.out(), "[]");
@@ -140,14 +145,11 @@ struct formatter<State> {
         return format_to(ctx.out(), "[{}]", Raw{set, 2});
       }
 
-      Raw a{set.substr(0, 1), 2};
-      Raw b{set.substr(set.size() - 1, 1), 2};
-      return format_to(ctx.out(), "[{}..{}]", a, b);
-    }
-
-    case Option::Range: {
-      auto [a, b] = std::get<Range>(state.variant());
-      return format_to(ctx.out(), "[{}-{}]", Raw{{&a, 1}, 2}, Raw{{&b, 1}, 2});
+      // NOTE: contiguous sets are shown as ranges
+      Raw a{std::string_view{set}.substr(0, 1), 2};
+      Raw b{std::string_view{set}.substr(set.size() - 1, 1), 2};
+      bool range = set.back() - set.front() + 1 == static_cast<i32>(set.size());
+      return format_to(ctx.out(), range ? "[{}-{}]" : "[{}..{}]", a, b);
     }
     }
     return ctx.out();
@@ -1,84 +1,219 @@
 #include "node.hpp"
 #include <algorithm>
+#include <map>
+#include <memory>
 
 namespace mcc::regex {
 
-auto Node::Cmp::operator()(const Node *lhs, const Node *rhs) const -> bool {
-  return lhs->index() < rhs->index();
-}
+constexpr u32 SEARCH_ROW_SIZE = 64;
+
+// Outcome of the lookahead states submitted during a match, keyed by (sequence, index). The
+// sub-search of a sequence does not depend on where it was submitted from, so the searches nested
+// in a match share the results until the outermost one ends. A search never submits a state twice
+// at the same index, only the lookaheads nested in another lookahead are repeated, by the
+// sub-searches of each index the outer one is submitted at.
+using Lookaheads = std::map<std::pair<const Node *, size_t>, size_t>;
+
+// Backtracking search of a single submit, the first match found ends the search so a node submitted
+// again at the same index has either failed there or is looping without consuming any character.
+// Each (node, index) pair is submitted at most once, bounding the search by O(nodes * characters),
+// and the backtracking paths are kept on an explicit stack instead of the call stack.
+class Search {
+  struct Frame {
+    const Node *node;
+    size_t match;
+    u32 edge;
+  };
+
+public:
+  // Buffers are reused by the following searches of the thread, a lookahead submitted during a
+  // search takes the next ones
+  static auto acquire() -> Search & {
+    thread_local std::vector<std::unique_ptr<Search>> pool{};
+    thread_local size_t depth = 0;
+    thread_local Lookaheads lookaheads{};
+
+    if (depth >= pool.size()) {
+      pool.push_back(std::make_unique<Search>());
+    }
 
-Node::Node(State state, size_t index) : m_edges(), m_index(index), m_state(state) {}
+    Search &search = *pool[depth++];
+    search.m_depth = &depth;
+    search.m_nested = depth > 1;
+    search.m_lookaheads = &lookaheads;
+    return search;
+  }
 
-auto Node::submit(std::string_view expr, size_t index) const -> size_t {
-  auto match = m_state.submit(expr, index);
+  // Search from <head> already submitted at <index> with <match>
+  auto run(const Node *head, std::string_view expr, size_t index, size_t match) -> size_t {
+    m_base = index;
+    visit(head, index);
+    m_frames.push_back({head, match, 0});
+    match = search(expr);
 
-  if (match != npos()) {
-    if (!branch() and match >= expr.size()) return match;
+    m_frames.clear();
+    m_rows.clear();
+    m_overflow.clear();
 
-    for (const Node *edge : m_edges) {
-      auto match_fwd = edge->submit(expr, match);
-      if (match_fwd != npos()) return match_fwd;
+    if (--*m_depth == 0) {
+      m_lookaheads->clear();
     }
 
-    if (!branch()) return match;
+    return match;
   }
 
-  return npos();
-}
+private:
+  auto search(std::string_view expr) -> size_t {
+    while (!m_frames.empty()) {
+      auto &[node, match, edge] = m_frames.back();
 
-auto Node::end() -> Node * {
-  Node *end = this;
+      if (edge == 0 and !node->branch() and match >= expr.size()) {
+        return match;
+      }
 
-  for (Node *member : members()) {
-    end = end->index() > member->index() ? end : member;
+      if (edge < node->edges().size()) {
+        const Node *next = node->edges().begin()[edge++];
+        enter(next, expr, match);
+        continue;
+      }
+
+      if (!node->branch()) {
+        return match;
+      }
+
+      m_frames.pop_back();
+    }
+
+    return npos();
   }
 
-  return end;
-}
+  auto enter(const Node *node, std::string_view expr, size_t index) -> bool {
+    if (!visit(node, index)) {
+      return false;
+    }
 
-auto Node::members() -> Set {
-  Set set{};
-  return make_members(set);
-}
+    size_t match = submit(node->state(), expr, index);
+
+    if (match != npos()) {
+      m_frames.push_back({node, match, 0});
+    }
 
-auto Node::concat(Node *node) -> Node * {
-  for (auto member : members()) {
-    if (!member->branch()) member->insert(node);
+    return match != npos();
   }
 
-  return node;
-}
+  auto submit(const State &state, std::string_view expr, size_t index) -> size_t {
+    const Node *sequence = nullptr;
+
+    if (!m_nested) {
+      return state.submit(expr, index);
+    }
 
-auto Node::map(u32 base) -> u32 {
-  for (auto member : members()) {
-    member->m_index += base;
+    switch (state.option()) {
+    case Option::Dash: sequence = std::get<Dash>(state.variant()).sequence; break;
+    case Option::Not: sequence = std::get<Not>(state.variant()).sequence; break;
+    default: return state.submit(expr, index);
+    }
+
+    // NOTE: the map keeps its iterators valid through the insertions of the nested searches
+    auto [it, inserted] = m_lookaheads->try_emplace({sequence, index}, npos());
+    if (inserted) it->second = state.submit(expr, index);
+    return it->second;
   }
 
-  return base;
-}
+  auto visit(const Node *node, size_t index) -> bool {
+    if (node->index() >= SEARCH_ROW_SIZE) {
+      return m_overflow.insert({node->index(), index}).second;
+    }
+
+    size_t row = index - m_base;
+    u64 bit = u64{1} << node->index();
 
-auto Node::merge(Node *node) -> Node * {
-  node->map(end()->index() + 1);
-  return concat(node);
+    if (row >= m_rows.size()) {
+      m_rows.resize(row + 1);
+    }
+    if (m_rows[row] & bit) {
+      return false;
+    }
+
+    m_rows[row] |= bit;
+    return true;
+  }
+
+  size_t *m_depth;
+  Lookaheads *m_lookaheads;
+  bool m_nested;
+  size_t m_base;
+  std::vector<Frame> m_frames;
+  std::vector<u64> m_rows;
+  std::set<std::pair<u32, size_t>> m_overflow;
+};
+
+auto Node::submit(std::string_view expr, size_t index) const -> size_t {
+  auto match = m_state.submit(expr, index);
+
+  // NOTE: most submits end on the head state, the search buffers are only taken past it
+  if (match == npos() or (!branch() and (match >= expr.size() or m_edges.empty()))) {
+    return match;
+  }
+
+  return Search::acquire().run(this, expr, index, match);
 }
 
-auto Node::push(Node *node) -> Node * {
-  node->map(end()->index() + 1);
-  return insert(node);
+// Point the edges and lookahead sequences of a node moved from the storage <from> at the storage
+// <to>, where the other nodes were moved in the same order
+void Node::relocate(const Node *from, Node *to) {
+  Variant &variant = m_state.variant();
+
+  for (Node *&edge : m_edges) {
+    edge = to + (edge - from);
+  }
+
+  if (auto *dash = std::get_if<Dash>(&variant)) {
+    dash->sequence = to + (dash->sequence - from);
+  }
+  if (auto *negation = std::get_if<Not>(&variant)) {
+    negation->sequence = to + (negation->sequence - from);
+  }
 }
 
-auto Node::insert(Node *node) -> Node * {
-  return *m_edges.insert(node).first;
+// Characters a match can start with, lookaheads are not checked so the set may be larger
+auto Node::first() const -> Charset {
+  Charset set{};
+  std::set<const Node *> visited{};
+  return make_first(set, visited, false);
 }
 
-auto Node::make_members(Set &set) -> Set & {
-  set.insert(this);
+auto Node::make_first(Charset &set, std::set<const Node *> &visited, bool exit) const
+  -> Charset & {
+  if (exit) {
+    // NOTE: an empty match can be followed by any character
+    if (!branch()) set.set();
+
+    for (const Node *edge : m_edges) {
+      edge->make_first(set, visited, false);
+    }
+
+    return set;
+  }
+
+  if (!visited.insert(this).second) {
+    return set;
+  }
+
+  switch (m_state.option()) {
+  case Option::None: return set;
+  case Option::Not: return set.set();
+  case Option::Epsilon:
+  case Option::Dash: return make_first(set, visited, true);
 
-  for (Node *edge : m_edges) {
-    if (edge->index() > index()) edge->make_members(set);
+  case Option::Text: {
+    auto content = std::get<Text>(m_state.variant()).content;
+    if (content.empty()) return make_first(set, visited, true);
+    return set.set(static_cast<u8>(content[0]));
   }
 
-  return set;
+  default: return set |= m_state.charset();
+  }
 }
 
 }  // namespace mcc::regex
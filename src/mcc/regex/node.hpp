@@ -3,69 +3,211 @@
 
 #include "mcc.hpp"
 #include "state.hpp"
-#include <compare>
+#include <algorithm>
+#include <array>
 #include <set>
 #include <span>
 #include <variant>
+#include <vector>
 
 namespace mcc::regex {
 class Node;
 
+constexpr size_t EDGES_INLINE = 2;
+
+// Edges sorted by index, nearly all nodes have one or two edges so they are kept inline in the
+// node and only spill to the heap past EDGES_INLINE
+class Edges {
+public:
+  constexpr Edges() : m_inline(), m_spill(), m_size(0) {}
+
+  constexpr auto insert(Node *node) -> Node *;
+
+  constexpr auto begin() -> Node ** {
+    return m_size > EDGES_INLINE ? m_spill.data() : m_inline.data();
+  }
+
+  constexpr auto end() -> Node ** {
+    return begin() + m_size;
+  }
+
+  constexpr auto begin() const -> Node *const * {
+    return m_size > EDGES_INLINE ? m_spill.data() : m_inline.data();
+  }
+
+  constexpr auto end() const -> Node *const * {
+    return begin() + m_size;
+  }
+
+  constexpr auto size() const -> size_t {
+    return m_size;
+  }
+
+  constexpr auto empty() const -> bool {
+    return m_size == 0;
+  }
+
+  constexpr auto back() const -> Node * {
+    return begin()[m_size - 1];
+  }
+
+private:
+  std::array<Node *, EDGES_INLINE> m_inline;
+  std::vector<Node *> m_spill;
+  u32 m_size;
+};
+
 class Node {
-  struct Cmp {
-    auto operator()(const Node *lhs, const Node *rhs) const -> bool;
-  };
-  using Set = std::set<Node *, Cmp>;
+  using Members = std::vector<Node *>;
 
 public:
-  Node() = default;
-  Node(State state, size_t index);
+  constexpr Node() : m_state(), m_index(0), m_edges() {}
+  constexpr Node(State state, size_t index);
 
   auto submit(std::string_view expr, size_t index) const -> size_t;
-  auto end() -> Node *;
-  auto concat(Node *node) -> Node *;
-  auto map(u32 base) -> u32;
-  auto members() -> Set;
-  auto merge(Node *node) -> Node *;
-  auto push(Node *node) -> Node *;
-  auto insert(Node *node) -> Node *;
-
-  auto index() const -> u32 {
+  auto first() const -> Charset;
+  void relocate(const Node *from, Node *to);
+  constexpr auto end() -> Node *;
+  constexpr auto concat(Node *node) -> Node *;
+  constexpr auto map(u32 base) -> u32;
+  constexpr auto members() -> Members;
+  constexpr auto merge(Node *node) -> Node *;
+  constexpr auto push(Node *node) -> Node *;
+  constexpr auto insert(Node *node) -> Node *;
+
+  constexpr auto index() const -> u32 {
     return m_index;
   }
 
-  auto edges() -> Set & {
+  constexpr auto edges() -> Edges & {
     return m_edges;
   }
 
-  auto edges() const -> const Set & {
+  constexpr auto edges() const -> const Edges & {
     return m_edges;
   }
 
-  auto state() const -> const State & {
+  constexpr auto state() const -> const State & {
     return m_state;
   }
 
-  auto breadth() const -> size_t {
+  constexpr auto breadth() const -> size_t {
     return m_edges.size();
   }
 
-  auto max_edge() const -> Node * {
-    return !m_edges.empty() ? *m_edges.rbegin() : nullptr;
+  constexpr auto max_edge() const -> Node * {
+    return !m_edges.empty() ? m_edges.back() : nullptr;
   }
 
-  auto branch() const -> bool {
+  constexpr auto branch() const -> bool {
     return !m_edges.empty() and max_edge()->index() > m_index;
   }
 
 private:
-  auto make_members(Set &set) -> Set &;
+  auto make_first(Charset &set, std::set<const Node *> &visited, bool exit) const -> Charset &;
 
   State m_state;
   u32 m_index;
-  Set m_edges;
+  Edges m_edges;
 };
 
+// NOTE: graph construction is constexpr so regexes can be parsed at compile time
+constexpr auto Edges::insert(Node *node) -> Node * {
+  Node **begin = m_size > EDGES_INLINE ? m_spill.data() : m_inline.data();
+  Node **it = std::lower_bound(begin, begin + m_size, node, [](Node *edge, Node *node) -> bool {
+    return edge->index() < node->index();
+  });
+
+  // NOTE: edges are unique by index
+  if (it != begin + m_size and (*it)->index() == node->index()) {
+    return *it;
+  }
+
+  if (m_size < EDGES_INLINE) {
+    std::copy_backward(it, begin + m_size, begin + m_size + 1);
+    m_size++;
+    return *it = node;
+  }
+
+  if (m_size == EDGES_INLINE) {
+    m_spill.assign(m_inline.begin(), m_inline.end());
+    it = m_spill.data() + (it - begin);
+  }
+
+  auto position = m_spill.begin() + (it - m_spill.data());
+  m_size++;
+  return *m_spill.insert(position, node);
+}
+
+constexpr Node::Node(State state, size_t index) : m_edges(), m_index(index), m_state(state) {}
+
+constexpr auto Node::end() -> Node * {
+  Node *end = this;
+
+  for (Node *member : members()) {
+    end = end->index() > member->index() ? end : member;
+  }
+
+  return end;
+}
+
+// Nodes reachable from this node through forward edges, sorted by index. Members are indexed
+// from this node so they are marked as visited by their index offset.
+constexpr auto Node::members() -> Members {
+  Members members{this};
+  std::vector<bool> visited(1, true);
+
+  for (size_t n = 0; n < members.size(); n++) {
+    for (Node *edge : members[n]->m_edges) {
+      if (edge->index() <= members[n]->index()) continue;
+
+      size_t offset = edge->index() - index();
+      if (offset >= visited.size()) visited.resize(offset * 2, false);
+
+      if (!visited[offset]) {
+        visited[offset] = true;
+        members.push_back(edge);
+      }
+    }
+  }
+
+  std::sort(members.begin(), members.end(), [](const Node *lhs, const Node *rhs) -> bool {
+    return lhs->index() < rhs->index();
+  });
+
+  return members;
+}
+
+constexpr auto Node::concat(Node *node) -> Node * {
+  for (auto member : members()) {
+    if (!member->branch()) member->insert(node);
+  }
+
+  return node;
+}
+
+constexpr auto Node::map(u32 base) -> u32 {
+  for (auto member : members()) {
+    member->m_index += base;
+  }
+
+  return base;
+}
+
+constexpr auto Node::merge(Node *node) -> Node * {
+  node->map(end()->index() + 1);
+  return concat(node);
+}
+
+constexpr auto Node::push(Node *node) -> Node * {
+  node->map(end()->index() + 1);
+  return insert(node);
+}
+
+constexpr auto Node::insert(Node *node) -> Node * {
+  return m_edges.insert(node);
+}
+
 }  // namespace mcc::regex
 
 #endif
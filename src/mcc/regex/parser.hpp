@@ -2,37 +2,39 @@
 #define MCC_REGEX_PARSER_HPP
 
 #include "mcc.hpp"
+#include "stack.hpp"
+#include <algorithm>
+#include <optional>
 #include <vector>
 
 namespace mcc::regex {
-class Stack;
-class Node;
 
 class Parser {
 public:
-  Parser(std::string_view src, Stack &stack);
-  auto parse() -> Node *;
+  constexpr Parser(std::string_view src, Stack &stack);
+  constexpr auto parse() -> Node *;
 
 private:
-  auto parse_new_token() -> Node *;
+  constexpr auto parse_new_token() -> Node *;
 
-  auto parse_sequence_src() -> std::string_view;
-  auto parse_binary_op(char op) -> std::pair<Node *, Node *>;
-  auto parse_pre_op(char op) -> Node *;
-  auto parse_post_op(char op) -> Node *;
-  
-  auto parse_set(std::string_view set) -> Node *;
-  auto parse_range() -> Node *;
-  auto parse_any() -> Node *;
-  auto parse_text(char q) -> Node *;
-  auto parse_sequence() -> Node *;
-  auto parse_dash() -> Node *;
-  auto parse_not() -> Node *;
-  auto parse_or() -> Node *;
-  auto parse_quest() -> Node *;
-  auto parse_star() -> Node *;
-  auto parse_plus() -> Node *;
-  auto parse_wave() -> Node *;
+  constexpr auto parse_sequence_src() -> std::string_view;
+  constexpr auto parse_binary_op(char op) -> std::pair<Node *, Node *>;
+  constexpr auto parse_pre_op(char op) -> Node *;
+  constexpr auto parse_post_op(char op) -> Node *;
+
+  constexpr auto parse_class(const Node *node) const -> std::optional<Bitmap>;
+  constexpr auto parse_set(std::string_view set) -> Node *;
+  constexpr auto parse_range() -> Node *;
+  constexpr auto parse_any() -> Node *;
+  constexpr auto parse_text(char q) -> Node *;
+  constexpr auto parse_sequence() -> Node *;
+  constexpr auto parse_dash() -> Node *;
+  constexpr auto parse_not() -> Node *;
+  constexpr auto parse_or() -> Node *;
+  constexpr auto parse_quest() -> Node *;
+  constexpr auto parse_star() -> Node *;
+  constexpr auto parse_plus() -> Node *;
+  constexpr auto parse_wave() -> Node *;
 
   auto exception(std::string_view desc) -> Exception;
 
@@ -42,6 +44,264 @@ private:
   std::string_view m_src;
 };
 
+// NOTE: parsing is constexpr so regexes can be built at compile time, where a regex exception
+// becomes a compile error
+constexpr Parser::Parser(std::string_view src, Stack &stack) :
+  m_stack(stack),
+  m_sequences(),
+  m_src(src),
+  m_token(src.end()) {}
+
+constexpr auto Parser::parse() -> Node * {
+  for (m_token = m_src.begin(); m_token < m_src.end(); m_token++) {
+    auto sequence = parse_new_token();
+    if (sequence) m_sequences.push_back(sequence);
+  }
+
+  for (size_t i = 1; i < m_sequences.size(); i++) {
+    m_sequences[0]->merge(m_sequences[i]);
+  }
+
+  return !m_sequences.empty() ? m_sequences[0] : nullptr;
+}
+
+constexpr auto Parser::parse_new_token() -> Node * {
+  if (m_token >= m_src.end()) {
+    return {};
+  }
+
+  switch (*m_token) {
+  case ' ':
+  case '\f':
+  case '\n':
+  case '\r':
+  case '\t':
+  case '\v': m_token++; return parse_new_token();
+
+  case '_': return parse_set("\n \v\b\f\t");
+  case 'a': return parse_set("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz");
+  case 'o': return parse_set("!#$%&()*+,-./:;<=>?@[\\]^`{|}~");
+  case 'n': return parse_set("0123456789");
+  case 'Q': return parse_set("\"");
+  case 'q': return parse_set("'");
+
+  case '[': return parse_range();
+  case '^': return parse_any();
+  case '!': return parse_not();
+  case '/': return parse_dash();
+  case '\'': return parse_text('\'');
+  case '`': return parse_text('`');
+  case '{': return parse_sequence();
+  case '|': return parse_or();
+  case '?': return parse_quest();
+  case '*': return parse_star();
+  case '+': return parse_plus();
+  case '~': return parse_wave();
+
+  case '}': throw exception("unmatched sequence brace, missing <{> operator");
+  case ']': throw exception("unmatched set brace, missing <[> operator");
+  default: throw exception("unrecognized token in regex, none of [_aonQq^'{}!|?*+~]");
+  }
+}
+
+constexpr auto Parser::parse_sequence_src() -> std::string_view {
+  i32 depth = 0;
+
+  const char *begin = m_token + 1;
+  const char *end = std::find_if(m_token, m_src.end(), [&depth](char token) -> bool {
+    switch (token) {
+    case '{': depth++; break;
+    case '}': depth--; break;
+    }
+    return depth < 1;
+  });
+
+  if (end == m_src.end()) {
+    throw exception("unmatched sequence brace, missing <}> character");
+  }
+
+  return {begin, m_token = end};
+}
+
+constexpr auto Parser::parse_binary_op(char op) -> std::pair<Node *, Node *> {
+  return {parse_pre_op(op), parse_post_op(op)};
+}
+
+constexpr auto Parser::parse_pre_op(char op) -> Node * {
+  if (m_sequences.empty()) {
+    throw exception(fmt::format("missing pre-operand for <{}> operator", op));
+  }
+
+  Node *operand = m_sequences.back();
+  m_sequences.pop_back();
+  return operand;
+}
+
+constexpr auto Parser::parse_post_op(char op) -> Node * {
+  m_token++;
+  auto head = parse_new_token();
+
+  if (!head) {
+    throw exception(fmt::format("missing post-operand for <{}> operator", op));
+  }
+
+  return head;
+}
+
+// Characters of a node consuming a single character and leading nowhere else
+constexpr auto Parser::parse_class(const Node *node) const -> std::optional<Bitmap> {
+  if (!node->edges().empty()) {
+    return std::nullopt;
+  }
+
+  const Variant &variant = node->state().variant();
+
+  if (auto *set = std::get_if<Set>(&variant)) {
+    return set->bitmap;
+  }
+  if (auto *text = std::get_if<Text>(&variant); text and text->content.size() == 1) {
+    return Bitmap{}.set(static_cast<u8>(text->content[0]));
+  }
+
+  return std::nullopt;
+}
+
+constexpr auto Parser::parse_set(std::string_view set) -> Node * {
+  return m_stack.push(Set{Bitmap::of(set)}, 0);
+}
+
+constexpr auto Parser::parse_range() -> Node * {
+  // Range format, with: ^ an ascii character, [ & ] range bounds
+  if (m_src.end() - m_token < 5 or m_token[2] != '-' or m_token[4] != ']') {
+    throw exception("range does not match the format: '[' ^ '-' ^ ']'");
+  }
+
+  char a = m_token[1];
+  char b = m_token[3];
+  m_token = &m_token[4];
+
+  return m_stack.push(Set{Bitmap::range(a, b)}, 0);
+}
+
+constexpr auto Parser::parse_any() -> Node * {
+  return m_stack.push(Any{}, 0);
+}
+
+constexpr auto Parser::parse_text(char q) -> Node * {
+  const char *begin = m_token + 1;
+  const char *end = std::find(begin, m_src.end(), q);
+
+  if (end == m_src.end()) {
+    throw exception("unmatched string literal quote, missing ending <'> character");
+  }
+
+  m_token = end;
+  std::string_view content(begin, end);
+  return m_stack.push(Text{content}, 0);
+}
+
+constexpr auto Parser::parse_sequence() -> Node * {
+  Parser parser{parse_sequence_src(), m_stack};
+  return parser.parse();
+}
+
+constexpr auto Parser::parse_dash() -> Node * {
+  return m_stack.push(Dash{parse_post_op('/')}, 0);
+}
+
+constexpr auto Parser::parse_not() -> Node * {
+  return m_stack.push(Not{parse_post_op('!')}, 0);
+}
+
+/*
+  Control flow structures:
+  
+  a: 1st binary operand
+  b: 2nd binary operand
+  o: unary operand
+  $: epsilon
+  ^: any
+  x: none
+  >: edge
+*/
+
+constexpr auto Parser::parse_or() -> Node * {
+  //   > a
+  // $
+  //   > b
+  auto [a, b] = parse_binary_op('|');
+
+  // NOTE: alternatives of single characters are merged into one set, tested with a single lookup
+  auto x = parse_class(a);
+  auto y = parse_class(b);
+
+  if (x and y) {
+    *a = Node{Set{*x |= *y}, a->index()};
+    m_stack.pop(b);
+    return a;
+  }
+
+  auto head = m_stack.push(Epsilon{}, 0);
+  head->push(a);
+  head->push(b);
+
+  return head;
+}
+
+constexpr auto Parser::parse_quest() -> Node * {
+  //   > o
+  // $
+  //   > $'
+  auto head = m_stack.push(Epsilon{}, 0);
+
+  head->merge(parse_pre_op('?'));
+  head->push(m_stack.push(Epsilon{}));
+
+  return head;
+}
+
+constexpr auto Parser::parse_star() -> Node * {
+  //   > o > $
+  // $
+  //   > $'
+  auto head = m_stack.push(Epsilon{}, 0);
+
+  head->merge(parse_pre_op('*'));
+  head->concat(head);
+  head->push(m_stack.push(Epsilon{}));
+
+  return head;
+}
+
+constexpr auto Parser::parse_plus() -> Node * {
+  // $ > e > $
+  auto head = parse_pre_op('+');
+  return head->concat(head);
+}
+
+constexpr auto Parser::parse_wave() -> Node * {
+  //   > b
+  // $
+  //   > a > $
+  //       > x
+
+  auto [a, b] = parse_binary_op('~');
+
+  auto head = m_stack.push(Epsilon{}, 0);
+  head->push(b);
+  head->push(a)->concat(head);
+  a->merge(m_stack.push(None{}));
+
+  return head;
+
+  // auto head = m_stack.push(Epsilon{}, 0);
+
+  // head->merge(parse_post_op('~'));
+  // head->push(m_stack.push(Any{}))->push(head);
+
+  // return head;
+}
+
 }  // namespace mcc::regex
 
 #endif
@@ -4,28 +4,142 @@
 #include "match.hpp"
 #include "parser.hpp"
 #include "stack.hpp"
+#include <array>
+#include <vector>
 
 namespace mcc::regex {
 
+// String literal usable as a template argument
+template<size_t N>
+struct Literal {
+  constexpr Literal(const char (&src)[N]) : data() {
+    std::copy_n(src, N, data);
+  }
+
+  constexpr auto view() const -> std::string_view {
+    return {data, N - 1};
+  }
+
+  char data[N];
+};
+
+// Regex parsed at compile time into an immutable table of the N nodes its parse needs
+template<size_t N>
+class StaticRegex {
+public:
+  consteval StaticRegex(std::string_view src) :
+    m_src(src),
+    m_nodes(),
+    m_members(),
+    m_size(0),
+    m_stack_size(0),
+    m_head(nullptr) {
+    Stack stack{m_nodes};
+    m_head = Parser{src, stack}.parse();
+    m_stack_size = stack.view().size();
+
+    if (m_head) {
+      auto members = m_head->members();
+      m_size = std::copy(members.begin(), members.end(), m_members.begin()) - m_members.begin();
+    }
+  }
+
+  constexpr auto head() const -> const Node * {
+    return m_head;
+  }
+
+  constexpr auto members() const -> std::span<Node *const> {
+    return {m_members.data(), m_size};
+  }
+
+  constexpr auto stack() const -> std::span<const Node> {
+    return {m_nodes.data(), m_stack_size};
+  }
+
+  constexpr auto src() const -> std::string_view {
+    return m_src;
+  }
+
+private:
+  std::string_view m_src;
+  std::array<Node, N> m_nodes;
+  std::array<Node *, N> m_members;
+  size_t m_size;
+  size_t m_stack_size;
+  Node *m_head;
+};
+
+// Count of nodes needed to parse <src>
+consteval auto static_regex_size(std::string_view src) -> size_t {
+  std::vector<Node> nodes(stack_capacity(src));
+  Stack stack{nodes};
+  Parser{src, stack}.parse();
+  return stack.peak();
+}
+
+template<Literal S>
+inline constexpr StaticRegex<static_regex_size(S.view())> static_regex{S.view()};
+
 class Regex {
 public:
   Regex(const Regex &) = delete;
   Regex &operator=(const Regex &) = delete;
 
-  Regex(std::string_view src) : m_src(src), m_stack() {
-    m_head = Parser{src, m_stack}.parse();
+  // NOTE: the source is parsed in a storage large enough for any source of its size, then the
+  // nodes are moved to an exactly sized one
+  Regex(std::string_view src) :
+    m_src(src),
+    m_nodes(),
+    m_owned_members(),
+    m_head(nullptr),
+    m_members(),
+    m_stack() {
+    std::vector<Node> storage(stack_capacity(src));
+    Stack stack{storage};
+    Node *head = Parser{src, stack}.parse();
+
+    auto view = stack.view();
+    m_nodes.assign(std::make_move_iterator(view.begin()), std::make_move_iterator(view.end()));
+
+    for (Node &node : m_nodes) {
+      node.relocate(storage.data(), m_nodes.data());
+    }
+
+    if (head) {
+      head = m_nodes.data() + (head - storage.data());
+      m_owned_members = head->members();
+    }
+
+    m_head = head;
+    m_members = m_owned_members;
+    m_stack = m_nodes;
   }
   Regex(const char *src) : Regex{std::string_view(src)} {}
 
-  auto head() const -> Node * {
+  // View of a static regex, nothing is parsed nor allocated
+  template<size_t N>
+  constexpr Regex(const StaticRegex<N> &regex) :
+    m_src(regex.src()),
+    m_nodes(),
+    m_owned_members(),
+    m_head(regex.head()),
+    m_members(regex.members()),
+    m_stack(regex.stack()) {}
+
+  constexpr auto head() const -> const Node * {
     return m_head;
   }
 
-  auto stack() const -> std::span<const Node> {
-    return m_stack.view();
+  // Nodes of the whole graph sorted by index, computed once the regex is parsed
+  constexpr auto members() const -> std::span<Node *const> {
+    return m_members;
   }
 
-  auto src() const -> std::string_view {
+  constexpr auto stack() const -> std::span<const Node> {
+    return m_stack;
+  }
+
+  constexpr auto src() const -> std::string_view {
     return m_src;
   }
 
@@ -38,9 +152,12 @@ public:
   }
 
 private:
-  Node *m_head;
-  Stack m_stack;
   std::string_view m_src;
+  std::vector<Node> m_nodes;
+  std::vector<Node *> m_owned_members;
+  const Node *m_head;
+  std::span<Node *const> m_members;
+  std::span<const Node> m_stack;
 };
 
 }  // namespace mcc::regex
@@ -53,6 +170,11 @@ namespace mcc::literals {
 inline regex::Regex operator""_rx(const char *src, size_t) {
   return Regex{src};
 }
+
+template<regex::Literal S>
+consteval auto operator""_srx() -> const auto & {
+  return regex::static_regex<S>;
+}
 }  // namespace mcc::literals
 
 #endif
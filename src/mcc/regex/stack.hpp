@@ -4,32 +4,54 @@
 #include "node.hpp"
 
 namespace mcc::regex {
-constexpr size_t STACK_CAPACITY = 128;
+// Nodes pushed at most by the parse of <src>, a token pushes at most two nodes
+constexpr auto stack_capacity(std::string_view src) -> size_t {
+  return src.size() * 2;
+}
 
+// Nodes of a regex pushed in the storage of its owner, a runtime or a static regex
 class Stack {
 public:
-  auto push(State state, size_t index = 0) -> Node * {
-    if (m_size + 1 > STACK_CAPACITY) {
+  constexpr Stack(std::span<Node> storage) : m_storage(storage), m_size(0), m_peak(0) {}
+
+  constexpr auto push(State state, size_t index = 0) -> Node * {
+    if (m_size + 1 > m_storage.size()) {
       throw Exception("regex exception", "stack size exceeded capacity");
     }
-    return &(m_stack.at(m_size++) = Node{state, index});
+    m_peak = std::max(m_peak, m_size + 1);
+    return &(m_storage[m_size++] = Node{state, index});
+  }
+
+  // Drop <node> when it is the last node pushed
+  constexpr auto pop(Node *node) -> bool {
+    if (m_size == 0 or node != &m_storage[m_size - 1]) {
+      return false;
+    }
+    m_storage[--m_size] = Node{};
+    return true;
+  }
+
+  // Most nodes held at once, the storage needed by the parse
+  constexpr auto peak() const -> size_t {
+    return m_peak;
   }
 
-  auto empty() const -> bool {
+  constexpr auto empty() const -> bool {
     return !m_size;
   }
 
-  auto view() -> std::span<Node> {
-    return {m_stack.data(), m_size};
+  constexpr auto view() -> std::span<Node> {
+    return m_storage.first(m_size);
   }
 
-  auto view() const -> std::span<const Node> {
-    return {m_stack.data(), m_size};
+  constexpr auto view() const -> std::span<const Node> {
+    return m_storage.first(m_size);
   }
 
 private:
+  std::span<Node> m_storage;
   size_t m_size;
-  std::array<Node, STACK_CAPACITY> m_stack;
+  size_t m_peak;
 };
 
 }  // namespace mcc::regex
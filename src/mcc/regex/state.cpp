@@ -32,16 +32,26 @@ auto State::submit(std::string_view expr, size_t index) const -> size_t {
   }
 
   case Option::Set: {
-    return std::get<Set>(m_variant).content.find(expr[index]) != npos() ? index + 1 : npos();
+    return std::get<Set>(m_variant).bitmap.test(static_cast<u8>(expr[index])) ? index + 1 : npos();
   }
 
-  case Option::Range: {
-    auto [a, b] = std::get<Range>(m_variant);
-    return a <= expr[index] and expr[index] <= b ? index + 1 : npos();
+  default: return npos();
   }
+}
 
-  default: return npos();
+// Characters submitted by a single character state, empty for the other options
+auto State::charset() const -> Charset {
+  Charset set{};
+
+  for (u32 c = 0; c < set.size(); c++) {
+    switch (option()) {
+    case Option::Any: set[c] = true; break;
+    case Option::Set: set[c] = std::get<Set>(m_variant).bitmap.test(c); break;
+    default: break;
+    }
   }
+
+  return set;
 }
 
 auto State::option() const -> Option {
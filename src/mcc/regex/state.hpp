@@ -2,11 +2,57 @@
 #define MCC_REGEX_STATE_HPP
 
 #include "mcc.hpp"
+#include <array>
+#include <bit>
+#include <bitset>
 #include <variant>
 
 namespace mcc::regex {
 class Node;
 
+// Bytes of a character class tested with a single bit lookup, std::bitset is not constexpr yet
+class Bitmap {
+public:
+  constexpr Bitmap() : m_words() {}
+
+  static constexpr auto of(std::string_view chars) -> Bitmap {
+    Bitmap bitmap{};
+    for (char c : chars) bitmap.set(static_cast<u8>(c));
+    return bitmap;
+  }
+
+  static constexpr auto range(char a, char b) -> Bitmap {
+    Bitmap bitmap{};
+    for (u32 c = 0; c < 256; c++) {
+      if (a <= static_cast<char>(c) and static_cast<char>(c) <= b) bitmap.set(c);
+    }
+    return bitmap;
+  }
+
+  constexpr auto set(u8 c) -> Bitmap & {
+    m_words[c >> 6] |= u64{1} << (c & 63);
+    return *this;
+  }
+
+  constexpr auto test(u8 c) const -> bool {
+    return m_words[c >> 6] >> (c & 63) & 1;
+  }
+
+  constexpr auto count() const -> size_t {
+    size_t count = 0;
+    for (u64 word : m_words) count += std::popcount(word);
+    return count;
+  }
+
+  constexpr auto operator|=(const Bitmap &other) -> Bitmap & {
+    for (u32 n = 0; n < m_words.size(); n++) m_words[n] |= other.m_words[n];
+    return *this;
+  }
+
+private:
+  std::array<u64, 4> m_words;
+};
+
 struct Epsilon {};
 struct Any {};
 struct None {};
@@ -20,10 +66,7 @@ struct Text {
   std::string_view content;
 };
 struct Set {
-  std::string_view content;
-};
-struct Range {
-  char a, b;
+  Bitmap bitmap;
 };
 
 enum class Option : u32 {
@@ -34,21 +77,26 @@ enum class Option : u32 {
   Dash,
   Text,
   Set,
-  Range,
 };
 
-using Variant = std::variant<Epsilon, Any, None, Not, Dash, Text, Set, Range>;
+using Variant = std::variant<Epsilon, Any, None, Not, Dash, Text, Set>;
+using Charset = std::bitset<256>;
 
 struct State {
 public:
   State() = default;
-  State(auto state) : m_variant(state) {}
+  constexpr State(auto state) : m_variant(state) {}
+
+  constexpr auto variant() const -> const Variant & {
+    return m_variant;
+  }
 
-  auto variant() const -> const Variant & {
+  auto variant() -> Variant & {
     return m_variant;
   }
 
   auto submit(std::string_view expr, size_t index) const -> size_t;
+  auto charset() const -> Charset;
   auto size() const -> size_t;
   auto option() const -> Option;
   auto has(Option option) const -> bool;
@@ -0,0 +1,115 @@
+#ifndef MCC_KEYWORD_HPP
+#define MCC_KEYWORD_HPP
+
+#include "trait.hpp"
+#include <array>
+#include <string_view>
+
+namespace mcc {
+using namespace trait;
+
+struct Keyword {
+  std::string_view name;
+  u32 trait;
+};
+
+constexpr Keyword KEYWORDS[]{
+  {"sizeof", Sizeof},
+  {"auto", KwAuto},
+  {"double", KwDouble},
+  {"char", KwChar},
+  {"float", KwFloat},
+  {"int", KwInt},
+  {"long", KwLong},
+  {"short", KwShort},
+  {"void", KwVoid},
+  {"enum", KwEnum},
+  {"typedef", KwTypedef},
+  {"union", KwUnion},
+  {"struct", KwStruct},
+  {"volatile", KwVolatile},
+  {"const", KwConst},
+  {"extern", KwExtern},
+  {"register", KwRegister},
+  {"static", KwStatic},
+  {"signed", KwSigned},
+  {"unsigned", KwUnsigned},
+  {"break", KwBreak},
+  {"case", KwCase},
+  {"continue", KwContinue},
+  {"default", KwDefault},
+  {"do", KwDo},
+  {"else", KwElse},
+  {"for", KwFor},
+  {"goto", KwGoto},
+  {"if", KwIf},
+  {"return", KwReturn},
+  {"switch", KwSwitch},
+  {"while", KwWhile},
+};
+
+constexpr size_t KEYWORD_COUNT = std::size(KEYWORDS);
+constexpr size_t KEYWORD_MIN = 2;
+constexpr size_t KEYWORD_MAX = 8;
+constexpr u32 KEYWORD_TABLE_SIZE = 128;
+
+constexpr auto keyword_hash(std::string_view name, u32 seed) -> u32 {
+  u32 hash = name.size();
+  hash = hash * seed + static_cast<u8>(name[0]);
+  hash = hash * seed + static_cast<u8>(name[1]);
+  hash = hash * seed + static_cast<u8>(name.back());
+  return (hash ^ hash >> 7) % KEYWORD_TABLE_SIZE;
+}
+
+// Search the first seed hashing every keyword into a distinct slot
+constexpr auto keyword_seed() -> u32 {
+  for (u32 seed = 1;; seed++) {
+    std::array<bool, KEYWORD_TABLE_SIZE> used{};
+    bool perfect = true;
+
+    for (const Keyword &keyword : KEYWORDS) {
+      u32 hash = keyword_hash(keyword.name, seed);
+      perfect = perfect and !used[hash];
+      used[hash] = true;
+    }
+
+    if (perfect) return seed;
+  }
+}
+
+constexpr u32 KEYWORD_SEED = keyword_seed();
+
+// Slot to keyword index + 1, zero for an empty slot
+constexpr auto keyword_table() -> std::array<u8, KEYWORD_TABLE_SIZE> {
+  std::array<u8, KEYWORD_TABLE_SIZE> table{};
+
+  for (size_t i = 0; i < std::size(KEYWORDS); i++) {
+    table[keyword_hash(KEYWORDS[i].name, KEYWORD_SEED)] = i + 1;
+  }
+
+  return table;
+}
+
+constexpr std::array<u8, KEYWORD_TABLE_SIZE> KEYWORD_TABLE = keyword_table();
+
+constexpr auto keyword_find(std::string_view name) -> const Keyword * {
+  if (name.size() < KEYWORD_MIN or name.size() > KEYWORD_MAX) {
+    return nullptr;
+  }
+
+  u8 slot = KEYWORD_TABLE[keyword_hash(name, KEYWORD_SEED)];
+
+  if (!slot or KEYWORDS[slot - 1].name != name) {
+    return nullptr;
+  }
+
+  return &KEYWORDS[slot - 1];
+}
+
+static_assert(keyword_find("while")->trait == KwWhile);
+static_assert(keyword_find("sizeof")->trait == Sizeof);
+static_assert(keyword_find("whilst") == nullptr);
+
+}  // namespace mcc
+
+#endif
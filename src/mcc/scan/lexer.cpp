@@ -5,20 +5,57 @@
 namespace mcc {
 using namespace trait;
 
-Lexer::Lexer(std::string_view src, SyntaxMap map) : m_src(src), m_next(src), m_map(map) {
+Lexer::Lexer(std::string_view src, SyntaxMap map) :
+  m_src(src),
+  m_next(src),
+  m_scanner(Scanner::of(map)) {
   if (!m_src.ends_with('\n')) {
     throw exception("source does not ends with an endline character '\\n'", dummy_token());
   }
 }
 
 auto Lexer::tokenize() -> Token {
-  auto token = match();
+  for (;;) {
+    auto token = match();
 
-  if (token.trait & CsCatch) {
-    throw exception(trait_catch_desc(token.trait), token);
+    if (token.trait & CsCatch) {
+      throw exception(trait_catch_desc(token.trait), token);
+    }
+    if (token.trait != Blank) {
+      return token;
+    }
   }
+}
 
-  return token.trait != Blank ? token : tokenize();
+// Records the erroneous tokens in <diagnostics> and carries on with the following token instead of
+// throwing, the erroneous tokens are never returned
+auto Lexer::tokenize(Diagnostics &diagnostics) -> Token {
+  for (;;) {
+    auto token = match();
+
+    if (token.trait & CsCatch) {
+      diagnostics.report("lexer exception", trait_catch_desc(token.trait), token);
+      continue;
+    }
+    if (token.trait != Blank) {
+      return token;
+    }
+  }
+}
+
+// Tokenizes the rest of the source up to the End token included
+auto Lexer::tokenize_all() -> TokenBuffer {
+  TokenBuffer buffer{m_src};
+
+  // NOTE: a token with the blank following it spans about 4 bytes of C source
+  buffer.reserve(m_next.size() / 4);
+
+  for (Token token = tokenize();; token = tokenize()) {
+    buffer.push(token);
+    if (token.trait == End) break;
+  }
+
+  return buffer;
 }
 
 auto Lexer::match() -> Token {
@@ -26,18 +63,27 @@ auto Lexer::match() -> Token {
     return Token{{m_src.end(), m_src.end()}, End};
   }
 
-  for (const auto &[trait, regex] : m_map) {
-    if (auto match = regex.match(m_next)) {
-      m_next = match.next();
-      return Token{match.view(), trait};
-    }
+  auto [size, trait] = m_scanner->match(m_next);
+
+  if (size == npos()) {
+    throw exception("unreachable, none should match everything", dummy_token());
   }
 
-  throw exception("unreachable, none should match everything", dummy_token());
+  Token token{m_next.substr(0, size), trait};
+  m_next.remove_prefix(size);
+  return token;
 }
 
 auto Lexer::exception(std::string_view desc, Token token) -> Exception {
-  return code_exception("lexer exception", desc, m_src, token);
+  return code_exception("lexer exception", desc, source_map(), token);
+}
+
+auto Lexer::source_map() -> const SourceMap & {
+  if (!m_source_map) {
+    m_source_map = std::make_shared<const SourceMap>(m_src);
+  }
+
+  return *m_source_map;
 }
 
 auto Lexer::dummy_token() -> Token {
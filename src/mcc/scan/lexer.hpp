@@ -1,8 +1,12 @@
 #ifndef MCC_LEXER_HPP
 #define MCC_LEXER_HPP
 
+#include "diagnostics.hpp"
+#include "scanner.hpp"
+#include "source_map.hpp"
 #include "syntax_map.hpp"
 #include "token.hpp"
+#include "token_buffer.hpp"
 
 namespace mcc {
 
@@ -10,8 +14,18 @@ class Lexer {
 public:
   Lexer(std::string_view src, SyntaxMap map = syntax_ansi());
   auto tokenize() -> Token;
+  auto tokenize(Diagnostics &diagnostics) -> Token;
+  auto tokenize_all() -> TokenBuffer;
   auto dummy_token() -> Token;
 
+  // Carries on tokenizing from <position> in the source
+  auto seek(const char *position) -> void {
+    m_next = m_src.substr(position - m_src.data());
+  }
+
+  // Line starts of the source, built on the first diagnostic or request
+  auto source_map() -> const SourceMap &;
+
   auto src() const -> std::string_view {
     return m_src;
   }
@@ -20,7 +34,8 @@ private:
   auto match() -> Token;
   auto exception(std::string_view desc, Token token) -> Exception;
 
-  SyntaxMap m_map;
+  std::shared_ptr<const Scanner> m_scanner;
+  std::shared_ptr<const SourceMap> m_source_map;
   std::string_view m_src;
   std::string_view m_next;
 };
@@ -0,0 +1,88 @@
+#include "matcher.hpp"
+#include "simd.hpp"
+#include <utility>
+
+namespace mcc {
+
+// Regex sources of the rules from syntax_ansi() with a specialized matcher
+constexpr std::pair<std::string_view, Matcher> MATCHERS[]{
+  {"{_|'@'}+", match_blank},
+  {"'//' {{{'\\'^}|^} ~ /'\n'}? /'\n'", match_comment_sl},
+  {"'/*' ^~ '*/'", match_comment_ml},
+  {"'#' {{{'\\'^}|^} ~ /'\n'}? /'\n'", match_directive},
+  {"'L'? Q {{{'\\'^}|^} ~ /{Q|'\n'}} ? {Q|'\n'}", match_string},
+};
+
+// Body of a line ending with an unescaped '\n', starting at <index> and excluding the newline
+static auto match_line(std::string_view next, size_t index) -> std::optional<size_t> {
+  const char *it = next.begin() + index;
+
+  for (;;) {
+    it = simd::find_any(it, next.end(), '\n', '\\', '\n');
+
+    // NOTE: backtracking from the end of input may still find a match, the regex engine decides
+    if (it == next.end() or (*it == '\\' and it + 1 == next.end())) {
+      return std::nullopt;
+    }
+    if (*it == '\n') {
+      return it - next.begin();
+    }
+
+    it += 2;
+  }
+}
+
+auto match_blank(std::string_view next) -> std::optional<size_t> {
+  size_t size = simd::skip_blank(next.begin(), next.end()) - next.begin();
+  return size != 0 ? size : npos();
+}
+
+auto match_comment_sl(std::string_view next) -> std::optional<size_t> {
+  return next.starts_with("//") ? match_line(next, 2) : npos();
+}
+
+auto match_comment_ml(std::string_view next) -> std::optional<size_t> {
+  if (!next.starts_with("/*")) {
+    return npos();
+  }
+
+  const char *end = simd::find_pair(next.begin() + 2, next.end(), '*', '/');
+  return end != next.end() ? end + 2 - next.begin() : npos();
+}
+
+auto match_directive(std::string_view next) -> std::optional<size_t> {
+  return next.starts_with('#') ? match_line(next, 1) : npos();
+}
+
+auto match_string(std::string_view next) -> std::optional<size_t> {
+  size_t index = next.starts_with('L') ? 1 : 0;
+
+  if (index >= next.size() or next[index] != '"') {
+    return npos();
+  }
+
+  const char *it = next.begin() + index + 1;
+
+  for (;;) {
+    it = simd::find_any(it, next.end(), '"', '\n', '\\');
+
+    if (it == next.end() or (*it == '\\' and it + 1 == next.end())) {
+      return std::nullopt;
+    }
+    if (*it != '\\') {
+      return it + 1 - next.begin();
+    }
+
+    it += 2;
+  }
+}
+
+auto matcher_find(std::string_view src) -> Matcher {
+  for (const auto &[source, matcher] : MATCHERS) {
+    if (source == src) return matcher;
+  }
+
+  return nullptr;
+}
+
+}  // namespace mcc
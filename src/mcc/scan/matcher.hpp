@@ -0,0 +1,25 @@
+#ifndef MCC_MATCHER_HPP
+#define MCC_MATCHER_HPP
+
+#include "mcc.hpp"
+#include <optional>
+#include <string_view>
+
+namespace mcc {
+
+// Specialized matcher of a syntax rule built on the simd kernels, returns the size of the match,
+// npos() when the rule does not match or std::nullopt when only the regex engine can decide
+using Matcher = auto (*)(std::string_view next) -> std::optional<size_t>;
+
+auto match_blank(std::string_view next) -> std::optional<size_t>;
+auto match_comment_sl(std::string_view next) -> std::optional<size_t>;
+auto match_comment_ml(std::string_view next) -> std::optional<size_t>;
+auto match_directive(std::string_view next) -> std::optional<size_t>;
+auto match_string(std::string_view next) -> std::optional<size_t>;
+
+// Matcher equivalent to the regex <src>, nullptr when there is none
+auto matcher_find(std::string_view src) -> Matcher;
+
+}  // namespace mcc
+
+#endif
@@ -0,0 +1,138 @@
+#include "parallel_lexer.hpp"
+#include "code_exception.hpp"
+#include "lexer.hpp"
+#include "scanner.hpp"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace mcc {
+using namespace trait;
+
+// Tokens lexed from <begin> up to the first non-blank token starting at or past <limit>, <end> is
+// the offset of that token or where no rule matched when <failed>
+struct Chunk {
+  size_t begin;
+  size_t limit;
+  size_t end;
+  bool failed;
+  TokenBuffer tokens;
+};
+
+static auto lex(const Scanner &scanner, std::string_view src, Chunk &chunk) -> void {
+  size_t index = chunk.begin;
+
+  while (index < src.size()) {
+    auto [size, trait] = scanner.match(src.substr(index));
+
+    if (size == npos()) {
+      chunk.failed = true;
+      break;
+    }
+    if (trait != Blank) {
+      if (index >= chunk.limit) break;
+      chunk.tokens.push(Token{src.substr(index, size), trait});
+    }
+
+    index += size;
+  }
+
+  chunk.end = index;
+}
+
+// Chunks starting after the first newline following each multiple of the chunk size
+static auto split(std::string_view src, size_t count) -> std::vector<Chunk> {
+  std::vector<Chunk> chunks{};
+  size_t begin = 0;
+
+  for (size_t n = 1; n <= count; n++) {
+    size_t limit = n < count ? src.find('\n', src.size() / count * n) : src.size();
+    limit = limit != npos() ? std::min(limit + 1, src.size()) : src.size();
+
+    if (limit > begin) {
+      chunks.push_back(Chunk{begin, limit, begin, false, TokenBuffer{src}});
+      begin = limit;
+    }
+  }
+
+  return chunks;
+}
+
+// Appends the tokens from the <from>th, the exceptions of the sequential lexer are thrown here
+// since a token of a chunk is only known to be part of the source once its chunk is joined
+static auto append(TokenBuffer &buffer, const TokenBuffer &tokens, size_t from) -> void {
+  auto traits = tokens.traits();
+  auto caught = std::find_if(traits.begin() + from, traits.end(), [](u32 trait) -> bool {
+    return trait & CsCatch;
+  });
+
+  if (caught != traits.end()) {
+    Token token = tokens[caught - traits.begin()];
+    throw code_exception("lexer exception", trait_catch_desc(token.trait), buffer.src(), token);
+  }
+
+  buffer.append(tokens, from);
+}
+
+auto tokenize_parallel(std::string_view src, SyntaxMap map, u32 threads, size_t chunk_size)
+  -> TokenBuffer {
+  Lexer lexer{src, map};
+  threads = threads ? threads : std::max(std::thread::hardware_concurrency(), 1u);
+
+  size_t count = std::min<size_t>(src.size() / std::max<size_t>(chunk_size, 1), threads * 4);
+  if (threads < 2 or count < 2) {
+    return lexer.tokenize_all();
+  }
+
+  auto scanner = Scanner::of(map);
+  auto chunks = split(src, count);
+  std::atomic<size_t> next = 0;
+  std::vector<std::thread> workers{};
+
+  for (u32 n = 0; n < std::min<size_t>(threads, chunks.size()); n++) {
+    workers.emplace_back([&]() {
+      for (size_t chunk = next++; chunk < chunks.size(); chunk = next++) {
+        lex(*scanner, src, chunks[chunk]);
+      }
+    });
+  }
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+
+  TokenBuffer buffer{src};
+  size_t cursor = 0;
+  size_t size = 0;
+
+  for (const Chunk &chunk : chunks) size += chunk.tokens.size();
+  buffer.reserve(size + 1);
+
+  for (Chunk &chunk : chunks) {
+    // NOTE: a token of the previous chunks may span the whole chunk
+    if (cursor >= chunk.limit) {
+      continue;
+    }
+
+    auto offsets = chunk.tokens.offsets();
+    auto joined = std::lower_bound(offsets.begin(), offsets.end(), cursor);
+
+    if (joined == offsets.end() ? cursor != chunk.end : *joined != cursor) {
+      chunk = Chunk{cursor, chunk.limit, cursor, false, TokenBuffer{src}};
+      lex(*scanner, src, chunk);
+      joined = chunk.tokens.offsets().begin();
+    }
+
+    append(buffer, chunk.tokens, joined - chunk.tokens.offsets().begin());
+    cursor = chunk.end;
+
+    if (chunk.failed) {
+      auto desc = "unreachable, none should match everything";
+      throw code_exception("lexer exception", desc, src, Token{src.substr(chunk.end, 1), None});
+    }
+  }
+
+  buffer.push(Token{{src.end(), src.end()}, End});
+  return buffer;
+}
+
+}  // namespace mcc
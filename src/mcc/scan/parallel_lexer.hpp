@@ -0,0 +1,24 @@
+#ifndef MCC_PARALLEL_LEXER_HPP
+#define MCC_PARALLEL_LEXER_HPP
+
+#include "syntax_map.hpp"
+#include "token_buffer.hpp"
+
+namespace mcc {
+
+constexpr size_t PARALLEL_CHUNK_SIZE = 256 * 1024;
+
+// Tokenizes <src> on <threads> threads, hardware concurrency when 0, producing the same tokens and
+// exceptions as Lexer::tokenize_all(). The source is split in chunks after newlines, each chunk is
+// lexed from its first character as if it started a token. The token streams are then stitched in
+// order, a chunk is kept from the first token where the stream of the previous chunks joins its
+// own. A chunk that never joins, having started inside a comment or a string, is lexed again.
+auto tokenize_parallel(
+  std::string_view src,
+  SyntaxMap map = syntax_ansi(),
+  u32 threads = 0,
+  size_t chunk_size = PARALLEL_CHUNK_SIZE) -> TokenBuffer;
+
+}  // namespace mcc
+
+#endif
@@ -0,0 +1,160 @@
+#include "scanner.hpp"
+#include <algorithm>
+
+namespace mcc {
+
+constexpr std::string_view IDENTIFIER_SRC = "{a|'_'} {a|'_'|n}*";
+constexpr std::string_view KEYWORD_SUFFIX = "' /!a";
+
+Scanner::Scanner(SyntaxMap map) :
+  m_map(map),
+  m_identifier(identifier()),
+  m_keywords(),
+  m_folded(fold()),
+  m_dfa(heads()),
+  m_dispatch(),
+  m_matchers(matchers()) {
+  for (u32 rule = 0; rule < map.size(); rule++) {
+    const regex::Node *head = map[rule].second.head();
+    if (!head or m_folded[rule]) continue;
+
+    regex::Charset first = head->first();
+
+    for (u32 c = 0; c < m_dispatch.size(); c++) {
+      if (first[c]) m_dispatch[c].push_back(rule);
+    }
+  }
+}
+
+auto Scanner::match(std::string_view next, bool partial) const -> std::pair<size_t, u32> {
+  auto [size, rule] = scan(next, partial);
+
+  if (size == npos()) {
+    return {npos(), None};
+  }
+
+  if (rule == m_identifier) {
+    return classify(next, size);
+  }
+
+  return {size, m_map[rule].first};
+}
+
+auto Scanner::ansi() -> std::shared_ptr<const Scanner> {
+  static const auto scanner = std::make_shared<const Scanner>(syntax_ansi());
+  return scanner;
+}
+
+auto Scanner::of(SyntaxMap map) -> std::shared_ptr<const Scanner> {
+  return map.data() == syntax_ansi().data() ? ansi() : std::make_shared<const Scanner>(map);
+}
+
+auto Scanner::scan(std::string_view next, bool partial) const -> std::pair<size_t, u32> {
+  for (u32 rule : !next.empty() ? candidates(next[0]) : std::span<const u32>{}) {
+    auto size = m_matchers[rule] ? m_matchers[rule](next) : std::nullopt;
+
+    // NOTE: on a partial input, only a match ending before the last character is known not to
+    // depend on the following input, the automaton decides the other cases
+    if (!size or (partial and (*size == npos() or *size >= next.size()))) break;
+    if (*size != npos()) return {*size, rule};
+  }
+
+  if (m_dfa.compiled() or next.empty() or partial) {
+    return m_dfa.scan(next, 0, partial);
+  }
+
+  for (u32 rule : candidates(next[0])) {
+    if (auto match = m_map[rule].second.match(next)) {
+      return {match.index(), rule};
+    }
+  }
+
+  return {npos(), 0};
+}
+
+auto Scanner::identifier() const -> u32 {
+  for (u32 rule = 0; rule < m_map.size(); rule++) {
+    const auto &[trait, regex] = m_map[rule];
+    if (trait == Identifier and regex.src() == IDENTIFIER_SRC) return rule;
+  }
+
+  return m_map.size();
+}
+
+auto Scanner::fold() -> std::vector<bool> {
+  std::vector<bool> folded(m_map.size(), false);
+  std::vector<regex::Charset> firsts{};
+
+  for (const auto &[trait, regex] : m_map) {
+    firsts.push_back(regex.head() ? regex.head()->first() : regex::Charset{});
+  }
+
+  // NOTE: rules are folded from the closest to the identifier rule, a rule left in between must not
+  // start like the keyword otherwise it would shadow the identifier
+  for (u32 rule = m_identifier; rule-- > 0;) {
+    const auto &[trait, regex] = m_map[rule];
+    std::string_view src = regex.src();
+
+    if (!src.starts_with('\'') or !src.ends_with(KEYWORD_SUFFIX)) {
+      continue;
+    }
+
+    auto name = src.substr(1, src.size() - 1 - KEYWORD_SUFFIX.size());
+    const Keyword *keyword = keyword_find(name);
+
+    if (!keyword or keyword->trait != trait or m_keywords[keyword - KEYWORDS]) {
+      continue;
+    }
+
+    bool shadowed = false;
+    for (u32 between = rule + 1; between < m_identifier; between++) {
+      shadowed = shadowed or (!folded[between] and firsts[between][static_cast<u8>(name[0])]);
+    }
+
+    if (!shadowed) {
+      folded[rule] = true;
+      m_keywords[keyword - KEYWORDS] = true;
+    }
+  }
+
+  return folded;
+}
+
+auto Scanner::heads() const -> std::vector<const regex::Node *> {
+  std::vector<const regex::Node *> heads{};
+
+  for (u32 rule = 0; rule < m_map.size(); rule++) {
+    heads.push_back(!m_folded[rule] ? m_map[rule].second.head() : nullptr);
+  }
+
+  return heads;
+}
+
+auto Scanner::matchers() const -> std::vector<Matcher> {
+  std::vector<Matcher> matchers{};
+
+  for (const auto &[trait, regex] : m_map) {
+    matchers.push_back(matcher_find(regex.src()));
+  }
+
+  return matchers;
+}
+
+// Keyword rules only match their name when followed by a character that is not a letter, so the
+// identifier is classified from its leading letters
+auto Scanner::classify(std::string_view next, size_t size) const -> std::pair<size_t, u32> {
+  auto letters = std::find_if_not(next.begin(), next.begin() + size, [](char c) -> bool {
+    return ('a' <= c and c <= 'z') or ('A' <= c and c <= 'Z');
+  });
+
+  auto name = std::string_view{next.begin(), letters};
+  const Keyword *keyword = keyword_find(name);
+
+  if (keyword and m_keywords[keyword - KEYWORDS] and name.size() < next.size()) {
+    return {name.size(), keyword->trait};
+  }
+
+  return {size, m_map[m_identifier].first};
+}
+
+}  // namespace mcc
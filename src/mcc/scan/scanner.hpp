@@ -0,0 +1,72 @@
+#ifndef MCC_SCANNER_HPP
+#define MCC_SCANNER_HPP
+
+#include "keyword.hpp"
+#include "matcher.hpp"
+#include "regex/dfa.hpp"
+#include "syntax_map.hpp"
+#include <array>
+#include <bitset>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace mcc {
+
+// Single automaton built once from a whole syntax map, the accepting states are tagged with the
+// rule priority so the first rule matching in the map still wins. When the map can't be compiled,
+// only the rules that can start with the leading character are tried.
+//
+// Keyword rules "'<keyword>' /!a" are folded into the identifier rule when no other rule in between
+// can start like the keyword, the identifier is then classified with the keyword perfect hash.
+class Scanner {
+public:
+  Scanner(SyntaxMap map);
+
+  // Returns the size and trait of the token starting <next>, npos() when no rule matches. When
+  // <partial>, more input follows <next> and npos() is also returned when the token depends on it
+  auto match(std::string_view next, bool partial = false) const -> std::pair<size_t, u32>;
+
+  auto map() const -> SyntaxMap {
+    return m_map;
+  }
+
+  auto dfa() const -> const regex::Dfa & {
+    return m_dfa;
+  }
+
+  auto candidates(char c) const -> std::span<const u32> {
+    return m_dispatch[static_cast<u8>(c)];
+  }
+
+  auto folded(u32 rule) const -> bool {
+    return m_folded[rule];
+  }
+
+  auto matcher(u32 rule) const -> Matcher {
+    return m_matchers[rule];
+  }
+
+  static auto ansi() -> std::shared_ptr<const Scanner>;
+  static auto of(SyntaxMap map) -> std::shared_ptr<const Scanner>;
+
+private:
+  auto scan(std::string_view next, bool partial) const -> std::pair<size_t, u32>;
+  auto identifier() const -> u32;
+  auto fold() -> std::vector<bool>;
+  auto heads() const -> std::vector<const regex::Node *>;
+  auto matchers() const -> std::vector<Matcher>;
+  auto classify(std::string_view next, size_t size) const -> std::pair<size_t, u32>;
+
+  SyntaxMap m_map;
+  u32 m_identifier;
+  std::bitset<KEYWORD_COUNT> m_keywords;
+  std::vector<bool> m_folded;
+  regex::Dfa m_dfa;
+  std::array<std::vector<u32>, 256> m_dispatch;
+  std::vector<Matcher> m_matchers;
+};
+
+}  // namespace mcc
+
+#endif
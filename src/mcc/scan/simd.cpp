@@ -0,0 +1,185 @@
+#include "simd.hpp"
+#include <bit>
+
+#if defined(__x86_64__) or defined(__i386__)
+  #define MCC_SIMD_X86
+  #include <immintrin.h>
+#endif
+
+namespace mcc::simd {
+
+struct Kernels {
+  auto (*skip_blank)(const char *begin, const char *end) -> const char *;
+  auto (*find_pair)(const char *begin, const char *end, char a, char b) -> const char *;
+  auto (*find_any)(const char *begin, const char *end, char a, char b, char c) -> const char *;
+  std::string_view isa;
+};
+
+static auto skip_blank_scalar(const char *begin, const char *end) -> const char * {
+  for (; begin < end; begin++) {
+    switch (*begin) {
+    case '\n':
+    case ' ':
+    case '\v':
+    case '\b':
+    case '\f':
+    case '\t':
+    case '@': break;
+    default: return begin;
+    }
+  }
+
+  return end;
+}
+
+static auto find_pair_scalar(const char *begin, const char *end, char a, char b) -> const char * {
+  for (; end - begin >= 2; begin++) {
+    if (begin[0] == a and begin[1] == b) return begin;
+  }
+
+  return end;
+}
+
+static auto find_any_scalar(const char *begin, const char *end, char a, char b, char c)
+  -> const char * {
+  for (; begin < end; begin++) {
+    if (*begin == a or *begin == b or *begin == c) return begin;
+  }
+
+  return end;
+}
+
+#ifdef MCC_SIMD_X86
+
+// NOTE: '\b' '\t' '\n' '\v' '\f' are contiguous, checked with a single signed range comparison
+static auto blank_sse2(__m128i v) -> __m128i {
+  __m128i offset = _mm_sub_epi8(v, _mm_set1_epi8('\b'));
+  __m128i range = _mm_and_si128(
+    _mm_cmpgt_epi8(offset, _mm_set1_epi8(-1)), _mm_cmpgt_epi8(_mm_set1_epi8(5), offset));
+  __m128i other = _mm_or_si128(
+    _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('@')));
+  return _mm_or_si128(range, other);
+}
+
+static auto skip_blank_sse2(const char *begin, const char *end) -> const char * {
+  for (; end - begin >= 16; begin += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+    u32 mask = ~_mm_movemask_epi8(blank_sse2(v)) & 0xFFFF;
+    if (mask) return begin + std::countr_zero(mask);
+  }
+
+  return skip_blank_scalar(begin, end);
+}
+
+static auto find_pair_sse2(const char *begin, const char *end, char a, char b) -> const char * {
+  for (; end - begin >= 17; begin += 16) {
+    __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+    __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin + 1));
+    __m128i eq = _mm_and_si128(
+      _mm_cmpeq_epi8(v0, _mm_set1_epi8(a)), _mm_cmpeq_epi8(v1, _mm_set1_epi8(b)));
+    if (u32 mask = _mm_movemask_epi8(eq)) return begin + std::countr_zero(mask);
+  }
+
+  return find_pair_scalar(begin, end, a, b);
+}
+
+static auto find_any_sse2(const char *begin, const char *end, char a, char b, char c)
+  -> const char * {
+  for (; end - begin >= 16; begin += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+    __m128i eq = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(a)), _mm_cmpeq_epi8(v, _mm_set1_epi8(b))),
+      _mm_cmpeq_epi8(v, _mm_set1_epi8(c)));
+    if (u32 mask = _mm_movemask_epi8(eq)) return begin + std::countr_zero(mask);
+  }
+
+  return find_any_scalar(begin, end, a, b, c);
+}
+
+__attribute__((target("avx2"))) static auto blank_avx2(__m256i v) -> __m256i {
+  __m256i offset = _mm256_sub_epi8(v, _mm256_set1_epi8('\b'));
+  __m256i range = _mm256_and_si256(
+    _mm256_cmpgt_epi8(offset, _mm256_set1_epi8(-1)),
+    _mm256_cmpgt_epi8(_mm256_set1_epi8(5), offset));
+  __m256i other = _mm256_or_si256(
+    _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('@')));
+  return _mm256_or_si256(range, other);
+}
+
+__attribute__((target("avx2"))) static auto skip_blank_avx2(const char *begin, const char *end)
+  -> const char * {
+  for (; end - begin >= 32; begin += 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+    u32 mask = ~static_cast<u32>(_mm256_movemask_epi8(blank_avx2(v)));
+    if (mask) return begin + std::countr_zero(mask);
+  }
+
+  return skip_blank_sse2(begin, end);
+}
+
+__attribute__((target("avx2"))) static auto
+find_pair_avx2(const char *begin, const char *end, char a, char b) -> const char * {
+  for (; end - begin >= 33; begin += 32) {
+    __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+    __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin + 1));
+    __m256i eq = _mm256_and_si256(
+      _mm256_cmpeq_epi8(v0, _mm256_set1_epi8(a)), _mm256_cmpeq_epi8(v1, _mm256_set1_epi8(b)));
+    if (u32 mask = _mm256_movemask_epi8(eq)) return begin + std::countr_zero(mask);
+  }
+
+  return find_pair_sse2(begin, end, a, b);
+}
+
+__attribute__((target("avx2"))) static auto
+find_any_avx2(const char *begin, const char *end, char a, char b, char c) -> const char * {
+  for (; end - begin >= 32; begin += 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+    __m256i eq = _mm256_or_si256(
+      _mm256_or_si256(
+        _mm256_cmpeq_epi8(v, _mm256_set1_epi8(a)), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(b))),
+      _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c)));
+    if (u32 mask = _mm256_movemask_epi8(eq)) return begin + std::countr_zero(mask);
+  }
+
+  return find_any_sse2(begin, end, a, b, c);
+}
+
+#endif
+
+static auto kernels_select() -> Kernels {
+#ifdef MCC_SIMD_X86
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("avx2")) {
+    return {skip_blank_avx2, find_pair_avx2, find_any_avx2, "avx2"};
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    return {skip_blank_sse2, find_pair_sse2, find_any_sse2, "sse2"};
+  }
+#endif
+
+  return {skip_blank_scalar, find_pair_scalar, find_any_scalar, "scalar"};
+}
+
+static auto kernels() -> const Kernels & {
+  static const Kernels kernels = kernels_select();
+  return kernels;
+}
+
+auto skip_blank(const char *begin, const char *end) -> const char * {
+  return kernels().skip_blank(begin, end);
+}
+
+auto find_pair(const char *begin, const char *end, char a, char b) -> const char * {
+  return kernels().find_pair(begin, end, a, b);
+}
+
+auto find_any(const char *begin, const char *end, char a, char b, char c) -> const char * {
+  return kernels().find_any(begin, end, a, b, c);
+}
+
+auto isa() -> std::string_view {
+  return kernels().isa;
+}
+
+}  // namespace mcc::simd
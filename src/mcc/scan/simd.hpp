@@ -0,0 +1,24 @@
+#ifndef MCC_SIMD_HPP
+#define MCC_SIMD_HPP
+
+#include "mcc.hpp"
+#include <string_view>
+
+// Byte scanning kernels of the lexer hot paths, the widest instruction set supported by the CPU is
+// selected at runtime: AVX2, SSE2 or the scalar fallback
+namespace mcc::simd {
+
+// First character that is not blank: "\n \v\b\f\t" or '@'
+auto skip_blank(const char *begin, const char *end) -> const char *;
+
+// First occurrence of the <a><b> pair
+auto find_pair(const char *begin, const char *end, char a, char b) -> const char *;
+
+// First occurrence of any of <a>, <b> or <c>
+auto find_any(const char *begin, const char *end, char a, char b, char c) -> const char *;
+
+auto isa() -> std::string_view;
+
+}  // namespace mcc::simd
+
+#endif
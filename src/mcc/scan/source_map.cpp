@@ -0,0 +1,32 @@
+#include "source_map.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace mcc {
+
+SourceMap::SourceMap(std::string_view src, size_t line) : m_src(src), m_line(line), m_starts{0} {
+  const char *begin = src.data();
+  const char *end = begin + src.size();
+
+  for (const void *it = begin; (it = std::memchr(begin, '\n', end - begin));) {
+    begin = static_cast<const char *>(it) + 1;
+    m_starts.push_back(begin - src.data());
+  }
+}
+
+auto SourceMap::locate(const char *pointer) const -> SourceLocation {
+  size_t offset = pointer - m_src.data();
+  auto it = std::upper_bound(m_starts.begin(), m_starts.end(), offset) - 1;
+  return SourceLocation{m_line + (it - m_starts.begin()), offset - *it};
+}
+
+auto SourceMap::line(size_t n) const -> std::string_view {
+  size_t begin = m_starts[n - m_line];
+  size_t end = n - m_line + 1 < m_starts.size() ? m_starts[n - m_line + 1] : m_src.size();
+
+  std::string_view line = m_src.substr(begin, end - begin);
+  if (line.ends_with('\n')) line.remove_suffix(1);
+  return line;
+}
+
+}  // namespace mcc
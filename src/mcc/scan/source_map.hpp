@@ -0,0 +1,48 @@
+#ifndef MCC_SOURCE_MAP_HPP
+#define MCC_SOURCE_MAP_HPP
+
+#include "token.hpp"
+#include <vector>
+
+namespace mcc {
+
+// Zero-based position of a character in the source
+struct SourceLocation {
+  size_t line;
+  size_t column;
+};
+
+// Offsets of the line starts of a source built in a single pass, a character of the source is
+// located by a binary search on the line starts instead of counting the endlines before it.
+// <line> is the number of the first line when the source is only a part of a larger one.
+class SourceMap {
+public:
+  SourceMap(std::string_view src, size_t line = 0);
+
+  auto locate(const char *pointer) const -> SourceLocation;
+
+  auto locate(Token token) const -> SourceLocation {
+    return locate(token.src.data());
+  }
+
+  // Content of the <n>th line without its endline character
+  auto line(size_t n) const -> std::string_view;
+
+  // NOTE: the endline ending the source starts an empty line, the line of the End token
+  auto lines() const -> size_t {
+    return m_starts.size();
+  }
+
+  auto src() const -> std::string_view {
+    return m_src;
+  }
+
+private:
+  std::string_view m_src;
+  size_t m_line;
+  std::vector<size_t> m_starts;
+};
+
+}  // namespace mcc
+
+#endif
@@ -0,0 +1,122 @@
+#include "stream_lexer.hpp"
+#include "code_exception.hpp"
+#include "trait.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+namespace mcc {
+using namespace trait;
+
+StreamLexer::StreamLexer(i32 fd, SyntaxMap map, size_t chunk_size) :
+  m_scanner(Scanner::of(map)),
+  m_buffer(),
+  m_chunk_size(std::max<size_t>(chunk_size, 1)),
+  m_line_begin(0),
+  m_begin(0),
+  m_size(0),
+  m_end(0),
+  m_line(0),
+  m_fd(fd),
+  m_eof(false) {}
+
+auto StreamLexer::tokenize() -> Token {
+  for (;;) {
+    auto token = match();
+
+    if (token.trait & CsCatch) {
+      throw exception(trait_catch_desc(token.trait), token);
+    }
+    if (token.trait != Blank) {
+      return token;
+    }
+  }
+}
+
+auto StreamLexer::match() -> Token {
+  advance();
+
+  for (;;) {
+    std::string_view next = window();
+
+    if (next.empty() and m_eof) {
+      return Token{next, End};
+    }
+
+    auto [size, trait] = m_scanner->match(next, !m_eof);
+
+    if (size != npos()) {
+      m_size = size;
+      return Token{next.substr(0, size), trait};
+    }
+
+    if (m_eof) {
+      throw exception("unreachable, none should match everything", Token{next.substr(0, 1), End});
+    }
+
+    read();
+  }
+}
+
+// Consumes the previous token, the line of an exception is tracked from the first line it spans
+auto StreamLexer::advance() -> void {
+  for (size_t end = m_begin + m_size; m_begin < end; m_begin++) {
+    if (m_buffer[m_begin] == '\n') {
+      m_line_begin = m_begin + 1;
+      m_line++;
+    }
+  }
+
+  m_size = 0;
+}
+
+// Moves the current line to the front of the buffer and appends the next chunk of input
+auto StreamLexer::read() -> void {
+  // NOTE: at most a chunk of the line before the token is kept for the exceptions
+  size_t begin = std::max(m_line_begin, m_begin - std::min(m_begin, m_chunk_size));
+
+  std::copy(m_buffer.begin() + begin, m_buffer.begin() + m_end, m_buffer.begin());
+  m_begin -= begin;
+  m_end -= begin;
+  m_line_begin = 0;
+
+  // NOTE: a token longer than a chunk doubles the reads, so it is not rescanned once per chunk
+  size_t chunk_size = std::max(m_chunk_size, m_end - m_begin);
+
+  if (m_buffer.size() < m_end + chunk_size) {
+    m_buffer.resize(std::max(m_end + chunk_size, m_chunk_size * 2));
+  }
+
+  ssize_t size = 0;
+  do {
+    size = ::read(m_fd, m_buffer.data() + m_end, chunk_size);
+  } while (size < 0 and errno == EINTR);
+
+  if (size < 0) {
+    auto desc = std::strerror(errno);
+    throw Exception{"io exception", "can't read from file descriptor {}: {}", m_fd, desc};
+  }
+
+  m_end += size;
+
+  // NOTE: the endline character required by the syntax is added when the input lacks it
+  if (size == 0) {
+    if (m_end == 0 or m_buffer[m_end - 1] != '\n') {
+      m_buffer.resize(std::max(m_buffer.size(), m_end + 1));
+      m_buffer[m_end++] = '\n';
+    }
+    m_eof = true;
+  }
+}
+
+auto StreamLexer::window() const -> std::string_view {
+  return {m_buffer.data() + m_begin, m_end - m_begin};
+}
+
+auto StreamLexer::exception(std::string_view desc, Token token) -> Exception {
+  std::string_view src{m_buffer.data() + m_line_begin, m_end - m_line_begin};
+  return code_exception("lexer exception", desc, src, token, m_line);
+}
+
+}  // namespace mcc
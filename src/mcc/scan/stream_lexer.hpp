@@ -0,0 +1,47 @@
+#ifndef MCC_STREAM_LEXER_HPP
+#define MCC_STREAM_LEXER_HPP
+
+#include "scanner.hpp"
+#include "syntax_map.hpp"
+#include "token.hpp"
+#include <vector>
+
+namespace mcc {
+
+constexpr size_t STREAM_CHUNK_SIZE = 64 * 1024;
+
+// Lexer reading its source in chunks from a file descriptor such as a pipe, only the current token
+// and the line before it are kept in memory. A token straddling two chunks is scanned again once
+// the next chunk is read, the views of a token are valid until the next call to tokenize().
+class StreamLexer {
+public:
+  StreamLexer(i32 fd, SyntaxMap map = syntax_ansi(), size_t chunk_size = STREAM_CHUNK_SIZE);
+  auto tokenize() -> Token;
+
+  // Bytes allocated for the buffer, a few chunks unless a token is longer than a chunk
+  auto capacity() const -> size_t {
+    return m_buffer.size();
+  }
+
+private:
+  auto match() -> Token;
+  auto advance() -> void;
+  auto read() -> void;
+  auto window() const -> std::string_view;
+  auto exception(std::string_view desc, Token token) -> Exception;
+
+  std::shared_ptr<const Scanner> m_scanner;
+  std::vector<char> m_buffer;
+  size_t m_chunk_size;
+  size_t m_line_begin;
+  size_t m_begin;
+  size_t m_size;
+  size_t m_end;
+  size_t m_line;
+  i32 m_fd;
+  bool m_eof;
+};
+
+}  // namespace mcc
+
+#endif
@@ -0,0 +1,117 @@
+#include "syntax_map.hpp"
+
+namespace mcc {
+
+auto syntax_ansi() -> SyntaxMap {
+  using namespace literals;
+
+  static constexpr std::pair<u32, Regex> map[]{
+    {Blank, "{_|'@'}+"_srx},
+    {CommentSL, "'//' {{{'\\'^}|^} ~ /'\n'}? /'\n'"_srx},
+    {CommentML, "'/*' ^~ '*/'"_srx},
+    {BadComment, "'/*'"_srx},
+    {Directive, "'#' {{{'\\'^}|^} ~ /'\n'}? /'\n'"_srx},
+
+    {Sizeof, "'sizeof' /!a"_srx},
+    {Star, "'*'"_srx},
+
+    // Every token has the same regex pattern "'<name>' /!a"
+    {KwAuto, "'auto' /!a"_srx},
+    {KwDouble, "'double' /!a"_srx},
+    {KwChar, "'char' /!a"_srx},
+    {KwFloat, "'float' /!a"_srx},
+    {KwInt, "'int' /!a"_srx},
+    {KwLong, "'long' /!a"_srx},
+    {KwShort, "'short' /!a"_srx},
+    {KwVoid, "'void' /!a"_srx},
+    {KwEnum, "'enum' /!a"_srx},
+    {KwTypedef, "'typedef' /!a"_srx},
+    {KwUnion, "'union' /!a"_srx},
+    {KwStruct, "'struct' /!a"_srx},
+    {KwVolatile, "'volatile' /!a"_srx},
+    {KwConst, "'const' /!a"_srx},
+    {KwExtern, "'extern' /!a"_srx},
+    {KwRegister, "'register' /!a"_srx},
+    {KwStatic, "'static' /!a"_srx},
+    {KwSigned, "'signed' /!a"_srx},
+    {KwUnsigned, "'unsigned' /!a"_srx},
+    {KwBreak, "'break' /!a"_srx},
+    {KwCase, "'case' /!a"_srx},
+    {KwContinue, "'continue' /!a"_srx},
+    {KwDefault, "'default' /!a"_srx},
+    {KwDo, "'do' /!a"_srx},
+    {KwElse, "'else' /!a"_srx},
+    {KwFor, "'for' /!a"_srx},
+    {KwGoto, "'goto' /!a"_srx},
+    {KwIf, "'if' /!a"_srx},
+    {KwReturn, "'return' /!a"_srx},
+    {KwSwitch, "'switch' /!a"_srx},
+    {KwWhile, "'while' /!a"_srx},
+
+    {CurlyBegin, "'{'"_srx},
+    {CurlyClose, "'}'"_srx},
+    {ParenBegin, "'('"_srx},
+    {ParenClose, "')'"_srx},
+    {CrochetBegin, "']'"_srx},
+    {CrochetClose, "'['"_srx},
+
+    {Arrow, "'->'"_srx},
+    {Increment, "'++'"_srx},
+    {Decrement, "'--'"_srx},
+    {Add, "'+'"_srx},
+    {Sub, "'-'"_srx},
+
+    {
+      Float,
+      "{[0-9]+ '.' [0-9]*} |"
+      "{[0-9]* '.' [0-9]+}  "
+      "{'e'|'E' {'+'|'-'}? [0-9]+}?"
+      "a*"_srx,
+    },
+
+    {
+      Integer,
+      "{'0b'|'0B' [0-1]+                     } |"
+      "{'0x'|'0X' [0-9]|[a-f]|[A-F]+         } |"
+      "{[0-9]+ {'e'|'E' {'+'|'-'}? [0-9]+ }? }  "
+      "a*"_srx,
+    },
+
+    {String, "'L'? Q {{{'\\'^}|^} ~ /{Q|'\n'}} ? {Q|'\n'}"_srx},
+    {BadString, "'L'? Q"_srx},
+    {Char, "'L'? q {{{'\\'^}|^} ~ /{q|'\n'}} {q|'\n'}"_srx},
+    {EmptyChar, "'L'? qq"_srx},
+    {BadChar, "'L'? q"_srx},
+    {Identifier, "{a|'_'} {a|'_'|n}*"_srx},
+
+    {Query, "'?'"_srx},
+    {Colon, "':'"_srx},
+    {Semicolon, "';'"_srx},
+    {Comma, "','"_srx},
+    {Dot, "'.'"_srx},
+    {And, "'&&'"_srx},
+    {Or, "'||'"_srx},
+    {BinNot, "'~'"_srx},
+    {BinOr, "'|'"_srx},
+    {BinXor, "'^'"_srx},
+    {BinShiftL, "'<<'"_srx},
+    {BinShiftR, "'>>'"_srx},
+    {Div, "'/'"_srx},
+    {Mod, "'%'"_srx},
+    {Equal, "'=='"_srx},
+    {NotEq, "'!='"_srx},
+    {LessEq, "'<='"_srx},
+    {GreaterEq, "'>='"_srx},
+    {Less, "'<'"_srx},
+    {Greater, "'>'"_srx},
+    {Not, "'!'"_srx},
+    {Assign, "'='"_srx},
+    {Ampersand, "'&'"_srx},
+
+    {None, "{^~/_}"_srx},
+  };
+
+  return {map};
+}
+
+}  // namespace mcc
@@ -25,6 +25,8 @@ struct Token {
 
   std::string_view src;
   u32 trait;
+  // NOTE: interned by the parser, SYMBOL_NONE until then
+  u32 symbol = 0;
 };
 
 }  // namespace mcc
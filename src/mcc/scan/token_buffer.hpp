@@ -0,0 +1,74 @@
+#ifndef MCC_TOKEN_BUFFER_HPP
+#define MCC_TOKEN_BUFFER_HPP
+
+#include "token.hpp"
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace mcc {
+
+// Tokens of a whole source stored as a structure of arrays, each token takes 12 bytes of offset,
+// length and trait instead of a 24 bytes Token. The tokens are indexed in source order, the last
+// one is always the End token.
+class TokenBuffer {
+public:
+  TokenBuffer(std::string_view src) : m_src(src), m_offsets(), m_lengths(), m_traits() {
+    if (src.size() > std::numeric_limits<u32>::max()) {
+      throw Exception{"token buffer exception", "source of {} bytes exceeds 4GiB", src.size()};
+    }
+  }
+
+  auto push(Token token) -> void {
+    m_offsets.push_back(token.src.begin() - m_src.begin());
+    m_lengths.push_back(token.src.size());
+    m_traits.push_back(token.trait);
+  }
+
+  // Appends the tokens of <buffer> from the <from>th, both buffers index the same source
+  auto append(const TokenBuffer &buffer, size_t from) -> void {
+    m_offsets.insert(m_offsets.end(), buffer.m_offsets.begin() + from, buffer.m_offsets.end());
+    m_lengths.insert(m_lengths.end(), buffer.m_lengths.begin() + from, buffer.m_lengths.end());
+    m_traits.insert(m_traits.end(), buffer.m_traits.begin() + from, buffer.m_traits.end());
+  }
+
+  auto reserve(size_t size) -> void {
+    m_offsets.reserve(size);
+    m_lengths.reserve(size);
+    m_traits.reserve(size);
+  }
+
+  auto operator[](size_t n) const -> Token {
+    return Token{m_src.substr(m_offsets[n], m_lengths[n]), m_traits[n]};
+  }
+
+  auto size() const -> size_t {
+    return m_traits.size();
+  }
+
+  auto src() const -> std::string_view {
+    return m_src;
+  }
+
+  auto offsets() const -> std::span<const u32> {
+    return m_offsets;
+  }
+
+  auto lengths() const -> std::span<const u32> {
+    return m_lengths;
+  }
+
+  auto traits() const -> std::span<const u32> {
+    return m_traits;
+  }
+
+private:
+  std::string_view m_src;
+  std::vector<u32> m_offsets;
+  std::vector<u32> m_lengths;
+  std::vector<u32> m_traits;
+};
+
+}  // namespace mcc
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef MCC_TOKEN_RING_HPP
+#define MCC_TOKEN_RING_HPP
+
+#include "token.hpp"
+#include <array>
+
+namespace mcc {
+
+constexpr size_t TOKEN_RING_CAPACITY = 32;
+static_assert(!(TOKEN_RING_CAPACITY & (TOKEN_RING_CAPACITY - 1)), "capacity is a power of two");
+
+// Lookahead of the parser as a fixed ring of tokens indexed by their position in the token stream.
+// Tokens are pushed once lexed and consumed by pop(), a mark pins the consumed tokens following it
+// so that the parser can rewind to the mark when it backtracks. Marks are nested, the outermost
+// one bounds the tokens kept in the ring.
+class TokenRing {
+public:
+  struct Mark {
+    size_t position;
+  };
+
+  TokenRing() : m_tokens(), m_begin(0), m_cursor(0), m_end(0), m_marks(0) {}
+
+  auto push(Token token) -> void {
+    if (m_end - m_begin >= TOKEN_RING_CAPACITY) {
+      throw Exception{"token ring exception", "lookahead exceeds {} tokens", TOKEN_RING_CAPACITY};
+    }
+    m_tokens[m_end++ % TOKEN_RING_CAPACITY] = token;
+  }
+
+  // <n>th token following the cursor, the ring holds at least n + 1 pending tokens
+  auto operator[](size_t n) const -> Token {
+    return m_tokens[(m_cursor + n) % TOKEN_RING_CAPACITY];
+  }
+
+  auto pop() -> Token {
+    Token token = (*this)[0];
+    m_cursor++;
+    if (!m_marks) m_begin = m_cursor;
+    return token;
+  }
+
+  auto mark() -> Mark {
+    if (!m_marks++) m_begin = m_cursor;
+    return Mark{m_cursor};
+  }
+
+  // Steps back to <mark>, the tokens consumed since are pending again
+  auto rewind(Mark mark) -> void {
+    m_cursor = mark.position;
+    release(mark);
+  }
+
+  // Drops <mark> keeping the tokens consumed since
+  auto release(Mark mark) -> void {
+    // NOTE: a mark outside of the kept tokens was released already or taken before a rewind
+    if (!m_marks or mark.position < m_begin or mark.position > m_cursor) {
+      throw Exception{"token ring exception", "mark at {} released out of order", mark.position};
+    }
+    if (!--m_marks) m_begin = m_cursor;
+  }
+
+  // Pending tokens not consumed yet
+  auto size() const -> size_t {
+    return m_end - m_cursor;
+  }
+
+  auto empty() const -> bool {
+    return m_end == m_cursor;
+  }
+
+  auto position() const -> size_t {
+    return m_cursor;
+  }
+
+private:
+  std::array<Token, TOKEN_RING_CAPACITY> m_tokens;
+  size_t m_begin;
+  size_t m_cursor;
+  size_t m_end;
+  u32 m_marks;
+};
+
+}  // namespace mcc
+
+#endif
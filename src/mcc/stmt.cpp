@@ -4,8 +4,12 @@
 
 namespace mcc {
 
-auto MainStmt::graph(GraphContext &ctx) -> GraphContext & {}
+auto MainStmt::graph(GraphContext &ctx) -> GraphContext & {
+  return ctx;
+}
 
-auto MainStmt::asm_x86(AsmContext &ctx) -> AsmContext & {}
+auto MainStmt::asm_x86(AsmContext &ctx) -> AsmContext & {
+  return ctx;
+}
 
 }  // namespace mcc
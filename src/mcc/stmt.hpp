@@ -19,6 +19,10 @@ class CompoundStmt : public Stmt {
 public:
   CompoundStmt(Token open, auto body, Token close) : m_braces{open, close}, m_body(body) {}
 
+  auto body() const -> const std::vector<Stmt *> & {
+    return m_body;
+  }
+
 private:
   Token m_braces[2];
   std::vector<Stmt *> m_body;
@@ -54,6 +58,14 @@ class InitStmt : public Stmt {
 public:
   InitStmt(struct Var *var, struct Expr *expr) : m_var(var), m_expr(expr) {}
 
+  auto var() const -> struct Var * {
+    return m_var;
+  }
+
+  auto expr() const -> struct Expr * {
+    return m_expr;
+  }
+
 private:
   struct Var *m_var;
   struct Expr *m_expr;
@@ -61,11 +73,31 @@ private:
 
 class FuncStmt : public Stmt {
 public:
-  FuncStmt(struct Func *func, CompoundStmt *body) : m_func(func), m_body(body) {}
+  FuncStmt(struct Func *func, CompoundStmt *body, Token range = {}) :
+    m_func(func),
+    m_body(body),
+    m_range(range) {}
+
+  // Body skipped by a lazy parser and not parsed yet, see Parser::parse_body()
+  auto lazy() const -> bool {
+    return !m_body and m_range.ok();
+  }
+
+  auto body() const -> CompoundStmt * {
+    return m_body;
+  }
+
+  // Tokens of the body from brace to brace when it was skipped
+  auto range() const -> Token {
+    return m_range;
+  }
 
 private:
+  friend class Parser;
+
   struct Func *m_func;
   CompoundStmt *m_body;
+  Token m_range;
 };
 
 class StructStmt : public Stmt {
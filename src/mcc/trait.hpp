@@ -173,6 +173,19 @@ constexpr auto trait_type(u32 trait) -> u32 {
   return (trait & TYPE_MASK);
 }
 
+// Whether <trait> is in <mask>, a mask without type bits matches the traits of any of its classes
+// or groups. Otherwise the mask is a union of traits sharing their class and group, e.g: Add | Sub.
+constexpr auto trait_match(u32 trait, u32 mask) -> bool {
+  trait &= ~OK_MASK;
+
+  if (!trait_type(mask)) {
+    return trait & mask;
+  }
+
+  return (trait & CLASS_MASK & ~mask) == 0 and (trait & GROUP_MASK) == (mask & GROUP_MASK) and
+         trait_type(trait) and (trait_type(trait) & ~mask) == 0;
+}
+
 constexpr auto trait_decompose(u32 trait) -> std::tuple<u32, u32, u32> {
   return {trait_class(trait), trait_group(trait), trait_type(trait)};
 }
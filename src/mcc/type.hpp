@@ -18,8 +18,9 @@ struct Type {
     Unsigned = KwUnsigned & TYPE_MASK
   };
 
+  // NOTE: a type of modifiers only is an int, e.g: unsigned a;
   auto ok() const -> bool {
-    return mode != 0 and defn != 0;
+    return mode != 0 or defn != nullptr;
   }
 
   u32 mode;
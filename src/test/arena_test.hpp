@@ -0,0 +1,84 @@
+#ifndef MCC_ARENA_TEST_HPP
+#define MCC_ARENA_TEST_HPP
+
+#include "arena.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace mcc {
+
+TEST(Arena, Make) {
+  Arena arena{};
+  auto *a = arena.make<u8>(u8{1});
+  auto *b = arena.make<u64>(u64{2});
+  auto *c = arena.make<std::string>("arena");
+
+  EXPECT_EQ(*a, 1);
+  EXPECT_EQ(*b, 2);
+  EXPECT_EQ(*c, "arena");
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % alignof(u64), 0);
+  EXPECT_EQ(arena.blocks(), 1);
+}
+
+TEST(Arena, Blocks) {
+  Arena arena{};
+
+  for (size_t n = 0; n < ARENA_BLOCK_SIZE / sizeof(u64) + 1; n++) {
+    arena.make<u64>(n);
+  }
+  EXPECT_EQ(arena.blocks(), 2);
+
+  // Objects larger than a block get their own block
+  arena.make<std::array<u8, ARENA_BLOCK_SIZE * 2>>();
+  EXPECT_EQ(arena.blocks(), 3);
+}
+
+TEST(Arena, Copy) {
+  Arena arena{};
+  std::array<u64, 4> items{1, 2, 3, 4};
+
+  auto span = arena.copy<u64>(std::span{items}.subspan(1));
+  items.fill(0);
+
+  EXPECT_EQ(span.size(), 3);
+  EXPECT_EQ(span[0], 2);
+  EXPECT_EQ(span[2], 4);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(span.data()) % alignof(u64), 0);
+  EXPECT_TRUE(arena.copy<u64>({}).empty());
+}
+
+TEST(Arena, Move) {
+  Arena arena{};
+  auto *a = arena.make<u64>(u64{1});
+
+  Arena moved{std::move(arena)};
+  auto *b = arena.make<u64>(u64{2});
+  auto *c = moved.make<u64>(u64{3});
+
+  // The moved arena no longer allocates in the block it gave away
+  EXPECT_EQ(arena.blocks(), 1);
+  EXPECT_EQ(moved.blocks(), 1);
+  EXPECT_EQ(c, a + 1);
+  EXPECT_EQ(*a + *b + *c, 6);
+}
+
+TEST(Arena, Destroy) {
+  struct Counter {
+    ~Counter() {
+      (*count)++;
+    }
+    size_t *count;
+  };
+
+  size_t count = 0;
+  {
+    Arena arena{};
+    for (size_t n = 0; n < 100; n++) arena.make<Counter>(&count);
+    EXPECT_EQ(count, 0);
+  }
+  EXPECT_EQ(count, 100);
+}
+
+}  // namespace mcc
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef MCC_AST_TEST_HPP
+#define MCC_AST_TEST_HPP
+
+#include "ast.hpp"
+#include <gtest/gtest.h>
+
+namespace mcc {
+
+TEST(Ast, Find) {
+  Ast ast{};
+  auto *type = ast.defn<Primitive>(Primitive::defn_int());
+
+  EXPECT_EQ(ast.find("int"), type);
+  EXPECT_EQ(ast.find(ast.intern("int")), type);
+  EXPECT_EQ(ast.find("main"), nullptr);
+
+  // The first definition of a name is kept
+  ast.defn<Var>(Type{}, "int");
+  EXPECT_EQ(ast.find("int"), type);
+}
+
+TEST(Ast, Scope) {
+  Ast ast{};
+  auto *type = ast.defn<Primitive>(Primitive::defn_int());
+  auto *global = ast.defn<Var>(Type{}, "a");
+  Ast scope{&ast};
+
+  EXPECT_EQ(scope.find("int"), type);
+  EXPECT_EQ(scope.intern("a"), global->symbol());
+
+  auto *local = scope.defn<Var>(Type{}, "a");
+  auto *other = scope.defn<Var>(Type{}, "b");
+
+  EXPECT_EQ(scope.find("a"), local);
+  EXPECT_EQ(scope.find("b"), other);
+  EXPECT_GT(other->symbol(), global->symbol());
+
+  // The ast is left untouched by its scopes
+  EXPECT_EQ(ast.find("a"), global);
+  EXPECT_EQ(ast.find("b"), nullptr);
+
+  auto locals = scope.clear_locals();
+  EXPECT_EQ(locals.size(), 2);
+  EXPECT_EQ(scope.find("a"), global);
+  EXPECT_EQ(scope.find("b"), nullptr);
+
+  // The adopted locals are given the symbols of the ast without being defined in it
+  ast.adopt(locals);
+  EXPECT_EQ(local->symbol(), global->symbol());
+  EXPECT_EQ(other->symbol(), ast.intern("b"));
+  EXPECT_EQ(ast.find("b"), nullptr);
+  ast.adopt(std::move(scope));
+}
+
+}  // namespace mcc
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef MCC_INTERNER_TEST_HPP
+#define MCC_INTERNER_TEST_HPP
+
+#include "interner.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace mcc {
+
+TEST(Interner, Intern) {
+  Interner interner{};
+  std::string name = "main";
+
+  u32 main = interner.intern(name);
+  u32 argc = interner.intern("argc");
+
+  EXPECT_EQ(main, 1);
+  EXPECT_EQ(argc, 2);
+  EXPECT_EQ(interner.intern("main"), main);
+  EXPECT_EQ(interner.find("argc"), argc);
+  EXPECT_EQ(interner.find("argv"), SYMBOL_NONE);
+
+  // Interned strings do not refer to the source
+  name[0] = 'p';
+  EXPECT_EQ(interner[main], "main");
+  EXPECT_EQ(interner.size(), 3);
+}
+
+TEST(Interner, Grow) {
+  Interner interner{};
+
+  for (u32 n = 0; n < 10000; n++) {
+    EXPECT_EQ(interner.intern(fmt::format("id_{}", n)), n + 1);
+  }
+  for (u32 n = 0; n < 10000; n++) {
+    EXPECT_EQ(interner.find(fmt::format("id_{}", n)), n + 1);
+    EXPECT_EQ(interner[n + 1], fmt::format("id_{}", n));
+  }
+  EXPECT_EQ(interner.find(""), SYMBOL_NONE);
+}
+
+}  // namespace mcc
+
+#endif
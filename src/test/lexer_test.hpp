@@ -2,7 +2,13 @@
 #define MCC_LEXER_TEST_HPP
 
 #include "scan/lexer.hpp"
+#include "scan/parallel_lexer.hpp"
+#include "scan/simd.hpp"
+#include "scan/stream_lexer.hpp"
+#include "scan/token_ring.hpp"
+#include <cstdio>
 #include <gtest/gtest.h>
+#include <memory>
 
 namespace mcc {
 using namespace trait;
@@ -41,12 +47,172 @@ static auto match_tokens(std::string_view src, const std::vector<Token> &&tokens
     }, \
     Exception)
 
+// Temporary file holding <src>, read back from its descriptor by the stream lexer
+static auto stream_file(std::string_view src) -> std::unique_ptr<FILE, decltype(&fclose)> {
+  std::unique_ptr<FILE, decltype(&fclose)> file{tmpfile(), &fclose};
+  fwrite(src.data(), 1, src.size(), file.get());
+  rewind(file.get());
+  return file;
+}
+
+static auto match_stream(std::string_view src, size_t chunk_size) -> testing::AssertionResult {
+  auto file = stream_file(src);
+  StreamLexer stream{fileno(file.get()), syntax_ansi(), chunk_size};
+  Lexer lexer{src};
+
+  for (size_t n = 0;; n++) {
+    Token expected = lexer.tokenize();
+    Token token = stream.tokenize();
+
+    if (token.trait != expected.trait or token.src != expected.src) {
+      return testing::AssertionFailure()
+             << "token " << n << " with chunks of " << chunk_size << ": '" << token.src
+             << "' != '" << expected.src << "'";
+    }
+    if (expected.trait == End) {
+      return testing::AssertionSuccess();
+    }
+  }
+}
+
 // Syntax test, we try to initialize the syntax map catching regex patterns errors
 
 TEST(Lexer, SyntaxAnsi) {
   auto syntax = syntax_ansi();
 }
 
+TEST(Lexer, Scanner) {
+  EXPECT_TRUE(Scanner::ansi()->dfa().compiled());
+
+  // First rule matching wins over longer matches
+  static const std::pair<u32, Regex> map[]{
+    {KwIf, "'if'"},
+    {Identifier, "a+"},
+    {Blank, "_+"},
+  };
+  Scanner scanner{map};
+  EXPECT_TRUE(scanner.dfa().compiled());
+  EXPECT_EQ(scanner.match("iffy\n"), std::pair(size_t{2}, u32{KwIf}));
+  EXPECT_EQ(scanner.match("fifo\n"), std::pair(size_t{4}, u32{Identifier}));
+  EXPECT_EQ(scanner.match("+"), std::pair(npos(), u32{None}));
+
+  // Lookaheads past the next character falls back to each regex in order
+  static const std::pair<u32, Regex> lookahead_map[]{
+    {KwIf, "'if' /'()'"},
+    {Identifier, "a+"},
+  };
+  Scanner lookahead_scanner{lookahead_map};
+  EXPECT_FALSE(lookahead_scanner.dfa().compiled());
+  EXPECT_EQ(lookahead_scanner.match("if()\n"), std::pair(size_t{2}, u32{KwIf}));
+  EXPECT_EQ(lookahead_scanner.match("if(\n"), std::pair(size_t{2}, u32{Identifier}));
+  EXPECT_EQ(lookahead_scanner.match("(\n"), std::pair(npos(), u32{None}));
+}
+
+TEST(Lexer, Dispatch) {
+  auto scanner = Scanner::ansi();
+  auto traits = [&scanner](char c) -> std::vector<u32> {
+    std::vector<u32> traits{};
+    for (u32 rule : scanner->candidates(c)) traits.push_back(scanner->map()[rule].first);
+    return traits;
+  };
+
+  EXPECT_EQ(traits('{'), (std::vector<u32>{CurlyBegin, None}));
+  EXPECT_EQ(traits('w'), (std::vector<u32>{Identifier, None}));
+  EXPECT_EQ(traits('7'), (std::vector<u32>{Float, Integer, None}));
+  EXPECT_EQ(traits('.'), (std::vector<u32>{Float, Dot, None}));
+  EXPECT_EQ(traits(' '), (std::vector<u32>{Blank, None}));
+  EXPECT_EQ(
+    traits('L'),
+    (std::vector<u32>{String, BadString, Char, EmptyChar, BadChar, Identifier, None}));
+}
+
+TEST(Lexer, KeywordFold) {
+  auto scanner = Scanner::ansi();
+  for (u32 rule = 0; rule < scanner->map().size(); rule++) {
+    u32 trait = scanner->map()[rule].first;
+    EXPECT_EQ(scanner->folded(rule), trait != Star and trait & CsKeyword) << trait_type_desc(trait);
+  }
+
+  // Keywords rules are only delimited by letters
+  EXPECT_TOKENS("int_x", {"int", KwInt}, {"_x", Identifier});
+  EXPECT_TOKENS("int2", {"int", KwInt}, {"2", Integer});
+  EXPECT_TOKENS("integer", {"integer", Identifier});
+  EXPECT_TOKENS("sizeof(x)", {"sizeof", Sizeof}, {"(", ParenBegin});
+  EXPECT_TOKENS("Int", {"Int", Identifier});
+
+  // A rule starting like the keyword between the keyword and the identifier prevents the folding
+  static const std::pair<u32, Regex> map[]{
+    {KwIf, "'if' /!a"},
+    {KwInt, "'int' /!a"},
+    {Integer, "'i' n+"},
+    {KwWhile, "'while' /!a"},
+    {Identifier, "{a|'_'} {a|'_'|n}*"},
+    {Blank, "_+"},
+  };
+  Scanner shadowed{map};
+  EXPECT_FALSE(shadowed.folded(0));
+  EXPECT_FALSE(shadowed.folded(1));
+  EXPECT_TRUE(shadowed.folded(3));
+  EXPECT_EQ(shadowed.match("if\n"), std::pair(size_t{2}, u32{KwIf}));
+  EXPECT_EQ(shadowed.match("i5\n"), std::pair(size_t{2}, u32{Integer}));
+  EXPECT_EQ(shadowed.match("while\n"), std::pair(size_t{5}, u32{KwWhile}));
+  EXPECT_EQ(shadowed.match("for\n"), std::pair(size_t{3}, u32{Identifier}));
+}
+
+TEST(Lexer, Matcher) {
+  auto scanner = Scanner::ansi();
+  std::string padding(40, 'x');
+  std::string blanks(40, ' ');
+
+  // Specialized matchers agree with the regex of their rule whenever they decide
+  const std::string sources[]{
+    "  \t\n@x",
+    blanks + "\v\b\f" + blanks + "x",
+    "x",
+    "// comment\n",
+    "//" + padding + "\\\n" + padding + "\n",
+    "// unterminated",
+    "// escaped \\",
+    "/* comment */",
+    "/*/ */",
+    "/*" + padding + "*" + padding + "*/",
+    "/* unterminated " + padding,
+    "#define X\n",
+    "#" + padding + "\\\n" + padding + "\n",
+    "\"string\"",
+    "L\"" + padding + "\\\"" + padding + "\"",
+    "\"weak\n",
+    "\"unterminated\\\"",
+    "L'c'",
+  };
+
+  for (u32 rule = 0; rule < scanner->map().size(); rule++) {
+    Matcher matcher = scanner->matcher(rule);
+    if (!matcher) continue;
+
+    for (std::string_view src : sources) {
+      if (auto size = matcher(src)) {
+        EXPECT_EQ(*size, scanner->map()[rule].second.match(src).index()) << src;
+      }
+    }
+  }
+
+  EXPECT_EQ(match_comment_sl("// unterminated"), std::nullopt);
+  EXPECT_EQ(match_string("\"unterminated\\\""), std::nullopt);
+  EXPECT_EQ(match_comment_ml("/* unterminated"), npos());
+  EXPECT_EQ(match_string("Lx"), npos());
+
+  for (size_t size = 0; size < 80; size++) {
+    std::string src = blanks + blanks;
+    src[size] = '"';
+    const char *begin = src.data(), *end = src.data() + src.size();
+
+    EXPECT_EQ(simd::skip_blank(begin, end) - begin, size) << simd::isa();
+    EXPECT_EQ(simd::find_any(begin, end, '"', '\n', '\\') - begin, size) << simd::isa();
+    EXPECT_EQ(simd::find_pair(begin, end, '"', ' ') - begin, size + 1 < 80 ? size : 80);
+  }
+}
+
 TEST(Lexer, Comment) {
   EXPECT_TOKENS("// Hello World \n", {"// Hello World ", CommentSL});
 
@@ -426,6 +592,271 @@ TEST(Lexer, Char) {
   EXPECT_LEXER_EXCEPTION("'''");
 }
 
+TEST(Lexer, Stream) {
+  std::string_view src = R"(#include <stdio.h>
+#define MAX(a, b) ((a) > (b) ? \
+  (a) : (b))
+
+/* multi-line comment spanning
+   several chunks of input */
+int integer_value = 0x7fffffff; // single-line comment
+static const char *string = L"escaped \" quote";
+double real = 3.14159e-10;
+
+int main(int argc, char **argv) {
+  for (int i = 0; i < argc; i++) printf("%s\n", argv[i]);
+  return sizeof(long) >= 8 ? 0 : 'x';
+}
+)";
+
+  for (size_t chunk_size : {1, 2, 3, 5, 8, 64, 4096}) {
+    EXPECT_TRUE(match_stream(src, chunk_size));
+  }
+
+  // The endline character is added at the end of the stream
+  auto file = stream_file("int x");
+  StreamLexer stream{fileno(file.get()), syntax_ansi(), 2};
+  EXPECT_EQ(stream.tokenize().trait, KwInt);
+  EXPECT_EQ(stream.tokenize().src, "x");
+  EXPECT_EQ(stream.tokenize().trait, End);
+}
+
+TEST(Lexer, StreamMemory) {
+  std::string_view line = "int x = y + 42; /* comment */\n";
+  std::string src{};
+  while (src.size() < 1 << 20) src += line;
+
+  auto file = stream_file(src);
+  StreamLexer stream{fileno(file.get()), syntax_ansi(), 4096};
+  size_t tokens = 0;
+
+  for (Token token = stream.tokenize(); token.trait != End; token = stream.tokenize()) {
+    tokens++;
+  }
+
+  EXPECT_EQ(tokens, src.size() / line.size() * 8);
+  EXPECT_LE(stream.capacity(), 4 * 4096);
+
+  // Tokens longer than a chunk grow the buffer
+  std::string comment = fmt::format("/*{}*/\n", std::string(1 << 16, ' '));
+  auto long_file = stream_file(comment);
+  StreamLexer long_stream{fileno(long_file.get()), syntax_ansi(), 4096};
+  EXPECT_EQ(long_stream.tokenize().src.size(), comment.size() - 1);
+  EXPECT_EQ(long_stream.tokenize().trait, End);
+
+  auto bad_file = stream_file("int x = 1;\n/* unterminated\n");
+  StreamLexer bad_stream{fileno(bad_file.get()), syntax_ansi(), 2};
+  EXPECT_THROW(
+    {
+      for (;;) {
+        if (bad_stream.tokenize().trait == End) break;
+      }
+    },
+    Exception);
+}
+
+TEST(Lexer, TokenBuffer) {
+  std::string_view src = "int main() {\n  return sizeof(long) + 0x2a; /* comment */\n}\n";
+  TokenBuffer buffer = Lexer{src}.tokenize_all();
+  Lexer lexer{src};
+
+  for (size_t n = 0; n < buffer.size(); n++) {
+    Token token = lexer.tokenize();
+    EXPECT_EQ(buffer[n].src, token.src);
+    EXPECT_EQ(buffer[n].src.data(), token.src.data());
+    EXPECT_EQ(buffer[n].trait, token.trait);
+  }
+
+  EXPECT_EQ(buffer.size(), 16);
+  EXPECT_EQ(buffer.traits().back(), End);
+  EXPECT_EQ(buffer.offsets()[1], 4);
+  EXPECT_EQ(buffer.lengths()[1], 4);
+  EXPECT_EQ(buffer[buffer.size() - 1].src.data(), src.end());
+}
+
+TEST(Lexer, TokenRing) {
+  Lexer lexer{"unsigned long int a = (long)b;\n"};
+  TokenRing ring{};
+
+  for (size_t n = 0; n < 4; n++) ring.push(lexer.tokenize());
+  EXPECT_EQ(ring.size(), 4);
+  EXPECT_EQ(ring[2].src, "int");
+
+  auto outer = ring.mark();
+  EXPECT_EQ(ring.pop().src, "unsigned");
+  auto inner = ring.mark();
+  EXPECT_EQ(ring.pop().src, "long");
+  ring.rewind(inner);
+  EXPECT_EQ(ring.pop().src, "long");
+  EXPECT_EQ(ring.pop().src, "int");
+  ring.rewind(outer);
+  EXPECT_EQ(ring.position(), 0);
+  EXPECT_EQ(ring[0].src, "unsigned");
+
+  // NOTE: consumed tokens are released without a mark
+  for (size_t n = 0; n < 4; n++) ring.pop();
+  for (size_t n = 0; n < 4 * TOKEN_RING_CAPACITY; n++) {
+    ring.push(Token{"a", Identifier});
+    ring.pop();
+  }
+  EXPECT_TRUE(ring.empty());
+
+  auto mark = ring.mark();
+  for (size_t n = 0; n < TOKEN_RING_CAPACITY; n++) {
+    ring.push(Token{"a", Identifier});
+    ring.pop();
+  }
+  EXPECT_THROW(ring.push(Token{"a", Identifier}), Exception);
+  ring.release(mark);
+  EXPECT_NO_THROW(ring.push(Token{"a", Identifier}));
+  EXPECT_THROW(ring.release(mark), Exception);
+
+  // NOTE: an inner mark taken past the outer one is lost when rewinding the outer one
+  auto first = ring.mark();
+  ring.pop();
+  auto second = ring.mark();
+  ring.rewind(first);
+  EXPECT_THROW(ring.release(second), Exception);
+}
+
+TEST(Lexer, SourceMap) {
+  std::string_view src = "int a;\n\n  long b; /* c\n */\n";
+  SourceMap map{src};
+
+  EXPECT_EQ(map.lines(), 5);
+  EXPECT_EQ(map.line(0), "int a;");
+  EXPECT_EQ(map.line(1), "");
+  EXPECT_EQ(map.line(2), "  long b; /* c");
+  EXPECT_EQ(map.line(4), "");
+
+  auto [line, column] = map.locate(src.data() + src.find("b;"));
+  EXPECT_EQ(line, 2);
+  EXPECT_EQ(column, 7);
+  EXPECT_EQ(map.locate(src.data()).line, 0);
+  EXPECT_EQ(map.locate(src.data() + src.size()).line, 4);
+  EXPECT_EQ(map.locate(src.data() + src.find(" */")).column, 0);
+
+  // NOTE: a part of a larger source is numbered from its first line
+  SourceMap part{src.substr(src.find("  long")), 2};
+  EXPECT_EQ(part.locate(part.src().data() + 3).line, 2);
+  EXPECT_EQ(part.line(3), " */");
+
+  Lexer lexer{src};
+  EXPECT_EQ(&lexer.source_map(), &lexer.source_map());
+  EXPECT_EQ(lexer.source_map().lines(), map.lines());
+}
+
+TEST(Lexer, Diagnostics) {
+  std::string_view src = "int $a;\nchar c = 'c';\nlong $b;\n/* unterminated\n";
+  Diagnostics diagnostics{};
+  Lexer lexer{src};
+  std::vector<std::string_view> tokens{};
+
+  for (Token token = lexer.tokenize(diagnostics); token.trait != End;) {
+    tokens.push_back(token.src);
+    token = lexer.tokenize(diagnostics);
+  }
+
+  ASSERT_EQ(diagnostics.size(), 3);
+  EXPECT_EQ(diagnostics[0].token.src, "$a;");
+  EXPECT_EQ(diagnostics[1].token.src, "$b;");
+  EXPECT_EQ(diagnostics[2].token.src, "/*");
+  EXPECT_EQ(diagnostics[2].desc, trait_catch_desc(BadComment));
+  EXPECT_EQ(tokens, (std::vector<std::string_view>{
+                      "int", "char", "c", "=", "'c'", ";", "long", "unterminated"}));
+
+  // NOTE: the recorded diagnostics format as the exceptions thrown by the lexer
+  try {
+    Lexer{src}.tokenize_all();
+    FAIL();
+  } catch (const Exception &exception) {
+    EXPECT_STREQ(diagnostics[0].exception(lexer.source_map()).what(), exception.what());
+  }
+
+  std::string message = diagnostics.format(lexer.source_map());
+  EXPECT_EQ(std::count(message.begin(), message.end(), '^'), 3 + 3 + 2);
+
+  // NOTE: merged diagnostics are ordered by position and reported once
+  Diagnostics merged{};
+  merged.report("lexer exception", diagnostics[2].desc, diagnostics[2].token);
+  merged.append(diagnostics);
+  merged.sort();
+  ASSERT_EQ(merged.size(), 3);
+  EXPECT_EQ(merged[0].token.src, "$a;");
+  EXPECT_EQ(merged[2].token.src, "/*");
+
+  Diagnostics overflow{};
+  for (size_t n = 0; n < DIAGNOSTICS_CAPACITY + 8; n++) overflow.report("", "", Token{});
+  EXPECT_EQ(overflow.size(), DIAGNOSTICS_CAPACITY);
+  EXPECT_EQ(overflow.dropped(), 8);
+}
+
+TEST(Lexer, Parallel) {
+  std::string src{};
+
+  // Chunks start inside comments, strings, directives and blanks
+  for (size_t n = 0; src.size() < 1 << 16; n++) {
+    src += fmt::format("int value_{} = {} + 0x{:x};\n", n, n, n);
+    if (n % 7 == 0) src += "/* comment\n spanning \"lines\"\n\n int x; */\n";
+    if (n % 11 == 0) src += "char *s = \"string \\\n continued\";\n";
+    if (n % 13 == 0) src += "#define MACRO(a) \\\n  ((a) + 1)\n\n\n";
+  }
+
+  TokenBuffer expected = Lexer{src}.tokenize_all();
+
+  for (size_t chunk_size : {1 << 6, 1 << 9, 1 << 12}) {
+    for (u32 threads : {1, 2, 4}) {
+      TokenBuffer buffer = tokenize_parallel(src, syntax_ansi(), threads, chunk_size);
+      ASSERT_EQ(buffer.size(), expected.size());
+
+      EXPECT_TRUE(std::ranges::equal(buffer.offsets(), expected.offsets()));
+      EXPECT_TRUE(std::ranges::equal(buffer.lengths(), expected.lengths()));
+      EXPECT_TRUE(std::ranges::equal(buffer.traits(), expected.traits()));
+    }
+  }
+
+  // A comment longer than the chunks
+  std::string comment = fmt::format("int a;\n/*{}*/\nint b;\n", std::string(1 << 12, '\n'));
+  EXPECT_EQ(tokenize_parallel(comment, syntax_ansi(), 4, 64).size(), 8);
+
+  // The exception of the sequential lexer is thrown
+  for (std::string bad : {src + "/* unterminated\n", src + "int $x;\n" + src}) {
+    std::string expected_what{};
+    std::string what{};
+
+    try {
+      Lexer{bad}.tokenize_all();
+    } catch (const Exception &exception) {
+      expected_what = exception.what();
+    }
+    try {
+      tokenize_parallel(bad, syntax_ansi(), 4, 1 << 9);
+    } catch (const Exception &exception) {
+      what = exception.what();
+    }
+
+    EXPECT_FALSE(what.empty());
+    EXPECT_EQ(what, expected_what);
+  }
+
+  // A position no rule matches fails the chunk lexing it
+  using namespace literals;
+  static constexpr std::pair<u32, Regex> words[]{
+    {Blank, "{_}+"_srx},
+    {Identifier, "{a}+"_srx},
+  };
+  std::string text{};
+  for (size_t n = 0; n < 1 << 10; n++) text += n == 1 << 9 ? "word 9\n" : "word word\n";
+
+  try {
+    tokenize_parallel(text, words, 4, 1 << 9);
+    FAIL();
+  } catch (const Exception &exception) {
+    EXPECT_TRUE(std::string_view{exception.what()}.find("none should match") != npos());
+    EXPECT_TRUE(std::string_view{exception.what()}.find("word 9") != npos());
+  }
+}
+
 TEST(Lexer, LongSource) {
   EXPECT_TOKENS(
     R"(
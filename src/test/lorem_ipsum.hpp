@@ -0,0 +1,25 @@
+#ifndef MCC_LOREM_IPSUM_HPP
+#define MCC_LOREM_IPSUM_HPP
+
+#include <string_view>
+
+namespace mcc::regex {
+
+constexpr std::string_view LOREM_IPSUM = R"(
+Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut
+labore et dolore magna aliqua. Id porta nibh venenatis cras sed felis eget velit. Viverra tellus
+in hac habitasse. Sed risus pretium quam vulputate dignissim suspendisse in est. In eu mi
+bibendum neque egestas congue quisque egestas. Mi proin sed libero enim sed faucibus turpis in.
+Aliquam vestibulum morbi blandit cursus. Tellus in hac habitasse platea dictumst vestibulum.
+Massa ultricies mi quis hendrerit. Molestie a iaculis at erat pellentesque adipiscing commodo.
+Vulputate eu scelerisque felis imperdiet proin fermentum. Vitae congue eu consequat ac felis. Nec
+ultrices dui sapien eget mi proin sed. Nunc mattis enim ut tellus elementum sagittis vitae et.
+Mauris ultrices eros in cursus turpis massa tincidunt dui ut. Nisi porta lorem mollis aliquam ut
+porttitor leo a diam. Diam phasellus vestibulum lorem sed risus ultricies. Arcu vitae elementum
+curabitur vitae nunc sed velit dignissim. Ut eu sem integer vitae justo eget magna fermentum
+iaculis.In eu mi bibendum neque.
+)";
+
+}  // namespace mcc::regex
+
+#endif
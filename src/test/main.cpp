@@ -1,4 +1,8 @@
+#include "arena_test.hpp"
+#include "ast_test.hpp"
+#include "interner_test.hpp"
 #include "lexer_test.hpp"
+#include "parser_test.hpp"
 #include "regex_test.hpp"
 #include <gtest/gtest.h>
 
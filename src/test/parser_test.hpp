@@ -0,0 +1,227 @@
+#ifndef MCC_PARSER_TEST_HPP
+#define MCC_PARSER_TEST_HPP
+
+#include "expr.hpp"
+#include "parser.hpp"
+#include "stmt.hpp"
+#include <gtest/gtest.h>
+
+namespace mcc {
+
+TEST(Parser, Defn) {
+  Parser parser{Lexer{"int x;\nunsigned long y = 1;\nint f() { int a = 1; int b = a; }\n"}};
+  Ast &ast = parser.parse();
+
+  EXPECT_TRUE(parser.diagnostics().empty()) << parser.diagnostics().format(parser.source_map());
+  EXPECT_NE(ast.find("x"), nullptr);
+  EXPECT_NE(ast.find("y"), nullptr);
+  EXPECT_NE(ast.find("f"), nullptr);
+  EXPECT_EQ(ast.find("a"), nullptr);
+  ASSERT_EQ(parser.bodies().size(), 1);
+  EXPECT_FALSE(parser.bodies()[0]->lazy());
+}
+
+// Initializer of the <n>th declaration in the first body of <parser>
+static auto parse_init_expr(Parser &parser, size_t n) -> Expr * {
+  return static_cast<InitStmt *>(parser.bodies()[0]->body()->body()[n])->expr();
+}
+
+TEST(Parser, Expr) {
+  Parser parser{Lexer{"int f() { int y = 2; int x = (int) y; int z = (long) -y; "
+                      "int u = y + 1; int w = y++; }\n"}};
+  parser.parse();
+  ASSERT_TRUE(parser.diagnostics().empty()) << parser.diagnostics().format(parser.source_map());
+
+  EXPECT_NE(dynamic_cast<ConstantExpr *>(parse_init_expr(parser, 0)), nullptr);
+  EXPECT_NE(dynamic_cast<CastExpr *>(parse_init_expr(parser, 1)), nullptr);
+  EXPECT_NE(dynamic_cast<CastExpr *>(parse_init_expr(parser, 2)), nullptr);
+  EXPECT_NE(dynamic_cast<BinaryExpr *>(parse_init_expr(parser, 3)), nullptr);
+  EXPECT_NE(dynamic_cast<UnaryExpr *>(parse_init_expr(parser, 4)), nullptr);
+}
+
+TEST(Parser, Invoke) {
+  Parser parser{Lexer{"int f(int a, int b);\nint g() { int x; int y = f(); int z = f(x, 1); }\n"}};
+  Ast &ast = parser.parse();
+  ASSERT_TRUE(parser.diagnostics().empty()) << parser.diagnostics().format(parser.source_map());
+
+  auto *f = static_cast<Func *>(ast.find("f"));
+  ASSERT_EQ(f->params().size(), 2);
+  EXPECT_EQ(f->params()[0]->name(), "a");
+  EXPECT_EQ(f->params()[1]->name(), "b");
+
+  auto *none = dynamic_cast<InvokeExpr *>(parse_init_expr(parser, 1));
+  auto *some = dynamic_cast<InvokeExpr *>(parse_init_expr(parser, 2));
+  ASSERT_NE(none, nullptr);
+  ASSERT_NE(some, nullptr);
+  EXPECT_EQ(none->args().size(), 0);
+  ASSERT_EQ(some->args().size(), 2);
+  EXPECT_NE(dynamic_cast<IdExpr *>(some->args()[0]), nullptr);
+  EXPECT_NE(dynamic_cast<ConstantExpr *>(some->args()[1]), nullptr);
+}
+
+TEST(Parser, Lazy) {
+  Parser parser{Lexer{"int f() { int a = 1; int b = a; }\nint g() { int c; }\nint h();\n"}, true};
+  Ast &ast = parser.parse();
+
+  ASSERT_TRUE(parser.diagnostics().empty()) << parser.diagnostics().format(parser.source_map());
+  ASSERT_EQ(parser.bodies().size(), 2);
+
+  // The bodies are skipped from brace to brace
+  FuncStmt *f = parser.bodies()[0];
+  FuncStmt *g = parser.bodies()[1];
+  EXPECT_TRUE(f->lazy());
+  EXPECT_EQ(f->body(), nullptr);
+  EXPECT_EQ(f->range().src, "{ int a = 1; int b = a; }");
+  EXPECT_EQ(g->range().src, "{ int c; }");
+
+  // Parsed on demand in any order
+  CompoundStmt *body = parser.parse_body(g);
+  ASSERT_NE(body, nullptr);
+  EXPECT_FALSE(g->lazy());
+  EXPECT_EQ(g->body(), body);
+  EXPECT_EQ(body->body().size(), 1);
+  EXPECT_TRUE(f->lazy());
+
+  body = parser.parse_body(f);
+  ASSERT_NE(body, nullptr);
+  EXPECT_EQ(body->body().size(), 2);
+
+  // An already parsed body is reused
+  EXPECT_EQ(parser.parse_body(f), body);
+  EXPECT_EQ(parser.parse_body(g), g->body());
+  EXPECT_TRUE(parser.diagnostics().empty());
+
+  // The locals of the bodies are not global
+  EXPECT_EQ(ast.find("a"), nullptr);
+  EXPECT_EQ(ast.find("c"), nullptr);
+}
+
+// Names and symbols of the variables defined by each body
+static auto parse_locals(Parser &parser) -> std::vector<std::vector<std::pair<std::string, u32>>> {
+  std::vector<std::vector<std::pair<std::string, u32>>> bodies{};
+
+  for (FuncStmt *stmt : parser.bodies()) {
+    auto &locals = bodies.emplace_back();
+    if (!stmt->body()) continue;
+
+    for (Stmt *local : stmt->body()->body()) {
+      Var *var = static_cast<InitStmt *>(local)->var();
+      locals.emplace_back(var->name(), var->symbol());
+    }
+  }
+
+  return bodies;
+}
+
+TEST(Parser, Bodies) {
+  std::string src{};
+  for (size_t n = 0; n < 64; n++) {
+    src += fmt::format("int f{0}() {{ int a = {0}; int b{0} = a; int c = b{0}; }}\n", n);
+    src += fmt::format("int g{0}() {{ int d = a; int $$$ e; }}\n", n);
+  }
+
+  Parser sequential{Lexer{src}, true};
+  sequential.parse();
+  sequential.parse_bodies(1);
+
+  Parser parallel{Lexer{src}, true};
+  Ast &ast = parallel.parse();
+  parallel.parse_bodies(4);
+
+  // The locals of a body are neither global nor seen by the other bodies
+  EXPECT_EQ(ast.find("a"), nullptr);
+  EXPECT_EQ(parse_locals(parallel)[1].size(), 2);
+  EXPECT_EQ(parse_locals(parallel)[1][0].first, "d");
+
+  EXPECT_FALSE(parallel.diagnostics().empty());
+  EXPECT_EQ(sequential.diagnostics().format(sequential.source_map()),
+            parallel.diagnostics().format(parallel.source_map()));
+  EXPECT_EQ(parse_locals(sequential), parse_locals(parallel));
+
+  // The symbols of the locals are unique to their name
+  EXPECT_EQ(parse_locals(parallel)[0][0].second, ast.intern("a"));
+  EXPECT_NE(parse_locals(parallel)[2][1].second, parse_locals(parallel)[0][1].second);
+}
+
+TEST(Parser, EagerBodies) {
+  std::string src{};
+  for (size_t n = 0; n < 8; n++) {
+    src += fmt::format("int f{0}() {{ int a = {0}; int b{0} = a; }}\n", n);
+    src += fmt::format("int g{0}() {{ int c = a; int $$$ d; int e = b{0}; }}\n", n);
+  }
+
+  Parser eager{Lexer{src}};
+  Ast &ast = eager.parse();
+
+  Parser lazy{Lexer{src}, true};
+  lazy.parse();
+  lazy.parse_bodies(2);
+
+  // The locals are scoped the same way whether the bodies were skipped or not
+  EXPECT_EQ(ast.find("a"), nullptr);
+  EXPECT_FALSE(eager.diagnostics().empty());
+  EXPECT_EQ(eager.diagnostics().format(eager.source_map()),
+            lazy.diagnostics().format(lazy.source_map()));
+
+  // NOTE: the symbols are interned in another order when the bodies are skipped
+  auto names = [](Parser &parser) {
+    std::vector<std::vector<std::string>> bodies{};
+    for (auto &locals : parse_locals(parser)) {
+      auto &names = bodies.emplace_back();
+      for (auto &[name, symbol] : locals) names.push_back(name);
+    }
+    return bodies;
+  };
+  EXPECT_EQ(names(eager), names(lazy));
+}
+
+TEST(Parser, LazyLexerError) {
+  Parser lazy{Lexer{"int f() { int $a; }\nint y;\nint z;\n"}, true};
+  Ast &ast = lazy.parse();
+
+  // The error is found while skipping the body, the declarations that follow are still parsed
+  EXPECT_EQ(lazy.diagnostics().size(), 1);
+  EXPECT_NE(ast.find("y"), nullptr);
+  EXPECT_NE(ast.find("z"), nullptr);
+  ASSERT_EQ(lazy.bodies().size(), 1);
+  EXPECT_NE(lazy.parse_body(lazy.bodies()[0]), nullptr);
+}
+
+TEST(Parser, UnbalancedBrace) {
+  Parser lazy{Lexer{"int f() { int a; { } \n"}, true};
+  lazy.parse();
+
+  ASSERT_FALSE(lazy.diagnostics().empty());
+  EXPECT_EQ(lazy.diagnostics()[0].desc, "unmatched curly bracket, missing <}> ending delimiter");
+  EXPECT_TRUE(lazy.bodies().empty());
+
+  Parser parser{Lexer{"int f() { int a;\n"}};
+  parser.parse();
+  EXPECT_FALSE(parser.diagnostics().empty());
+}
+
+TEST(Parser, Recover) {
+  Parser parser{Lexer{"int a = ;\nint b;\n@@@\nint c;\nint d = ;\nint e;\n"}};
+  Ast &ast = parser.parse();
+
+  // Every error is reported and the following statements are still parsed
+  EXPECT_GE(parser.diagnostics().size(), 3);
+  EXPECT_NE(ast.find("b"), nullptr);
+  EXPECT_NE(ast.find("c"), nullptr);
+  EXPECT_NE(ast.find("e"), nullptr);
+
+  // A declaration without a name is reported once and defines nothing
+  Parser unnamed{Lexer{"int = 1;\nint 2;\nint f;\n"}};
+  EXPECT_NE(unnamed.parse().find("f"), nullptr);
+  EXPECT_EQ(unnamed.diagnostics().size(), 2) << unnamed.diagnostics().format(unnamed.source_map());
+
+  // The delimiter of a statement missing its expression still ends it
+  for (const Diagnostic &diagnostic : parser.diagnostics()) {
+    auto exception = diagnostic.exception(parser.source_map());
+    EXPECT_NE(diagnostic.desc, "unexpected token") << exception.what();
+  }
+}
+
+}  // namespace mcc
+
+#endif
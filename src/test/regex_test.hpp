@@ -1,6 +1,8 @@
 #ifndef MCC_REGEX_TEST_HPP
 #define MCC_REGEX_TEST_HPP
 
+#include "lorem_ipsum.hpp"
+#include "regex/dfa.hpp"
 #include "regex/regex.hpp"
 #include <gtest/gtest.h>
 
@@ -8,25 +10,35 @@ namespace mcc::regex {
 using namespace std::string_view_literals;
 using namespace literals;
 
-constexpr std::string_view LOREM_IPSUM = R"(
-Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut
-labore et dolore magna aliqua. Id porta nibh venenatis cras sed felis eget velit. Viverra tellus
-in hac habitasse. Sed risus pretium quam vulputate dignissim suspendisse in est. In eu mi
-bibendum neque egestas congue quisque egestas. Mi proin sed libero enim sed faucibus turpis in.
-Aliquam vestibulum morbi blandit cursus. Tellus in hac habitasse platea dictumst vestibulum.
-Massa ultricies mi quis hendrerit. Molestie a iaculis at erat pellentesque adipiscing commodo.
-Vulputate eu scelerisque felis imperdiet proin fermentum. Vitae congue eu consequat ac felis. Nec
-ultrices dui sapien eget mi proin sed. Nunc mattis enim ut tellus elementum sagittis vitae et.
-Mauris ultrices eros in cursus turpis massa tincidunt dui ut. Nisi porta lorem mollis aliquam ut
-porttitor leo a diam. Diam phasellus vestibulum lorem sed risus ultricies. Arcu vitae elementum
-curabitur vitae nunc sed velit dignissim. Ut eu sem integer vitae justo eget magna fermentum
-iaculis.In eu mi bibendum neque.
-)";
-
 inline auto quoted(std::string_view expression) -> std::string {
   return fmt::format("'{}'", expression);
 }
 
+// Compare the compiled automaton against the backtracking engine on each expression
+static auto match_dfa(std::string_view src, const std::vector<std::string_view> &&exprs)
+  -> testing::AssertionResult {
+  Regex regex{src};
+  Dfa dfa{regex};
+
+  if (!dfa.compiled()) {
+    return testing::AssertionFailure() << "'" << src << "' is not compiled";
+  }
+
+  for (std::string_view expr : exprs) {
+    auto index = dfa.match(expr).index();
+    auto expected = regex.match(expr).index();
+
+    if (index != expected) {
+      return testing::AssertionFailure()
+             << "'" << src << "' on '" << expr << "': " << index << " != " << expected;
+    }
+  }
+
+  return testing::AssertionSuccess();
+}
+
+#define EXPECT_DFA(src, ...) EXPECT_TRUE(match_dfa(src, {__VA_ARGS__}))
+
 TEST(Regex, UnknownToken) {
   EXPECT_THROW("N"_rx, Exception);
   EXPECT_THROW(")"_rx, Exception);
@@ -95,6 +107,29 @@ TEST(Regex, Set) {
   EXPECT_FALSE("q"_rx.match("&"));
 }
 
+TEST(Regex, Bitmap) {
+  constexpr Bitmap digits = Bitmap::range('0', '9');
+  static_assert(digits.count() == 10 and digits.test('0') and digits.test('9'));
+  static_assert(!digits.test('/') and !digits.test(':'));
+  static_assert(Bitmap::of("abc").count() == 3);
+
+  // Alternatives of single characters are merged into one set state
+  Regex identifier{"{a|'_'|n}*"};
+  EXPECT_EQ(identifier.stack().size(), 3);
+  EXPECT_EQ(identifier.match("snake_case_42 x").index(), 13);
+
+  Regex hex{"[0-9]|[a-f]|[A-F]"};
+  EXPECT_EQ(hex.stack().size(), 1);
+  EXPECT_TRUE(hex.head()->state().has(Option::Set));
+  EXPECT_TRUE(hex.match("F"));
+  EXPECT_TRUE(hex.match("7"));
+  EXPECT_FALSE(hex.match("g"));
+
+  // Alternatives that are not single characters keep their priority
+  EXPECT_EQ("{'a'|'ab'}"_rx.match("ab").index(), 1);
+  EXPECT_EQ("{'a'+|'b'}"_rx.match("aab").index(), 2);
+}
+
 TEST(Regex, Sequence) {
   EXPECT_TRUE("{'abc'}"_rx.match("abc"));
   EXPECT_TRUE("{'ab'} {'c'}"_rx.match("abc"));
@@ -177,6 +212,132 @@ TEST(Regex, Wave) {
   EXPECT_THROW("{}~"_rx, Exception);
 }
 
+TEST(Regex, Linear) {
+  // Exponential for a plain backtracking, each (node, index) pair is submitted at most once
+  std::string a(4096, 'a');
+  EXPECT_FALSE("{'a'|'a'}+ 'b'"_rx.match(a));
+  EXPECT_FALSE("{'a'+}+ 'b'"_rx.match(a));
+  EXPECT_FALSE("{'a'|'aa'}~'b'"_rx.match(a));
+  EXPECT_EQ("{'a'|'a'}+ 'b'"_rx.match(a + 'b').index(), a.size() + 1);
+
+  // Loops without consuming any character fail instead of recursing forever
+  EXPECT_EQ("{'a'*}~'b'"_rx.match("aaab").index(), 4);
+  EXPECT_FALSE("{'a'*}~'b'"_rx.match("aaa"));
+  EXPECT_EQ("{'a'?}*"_rx.match("aab").index(), 2);
+
+  // Backtracking paths live on the heap, long matches do not overflow the call stack
+  std::string comment = fmt::format("/*{}*/", std::string(1 << 20, ' '));
+  EXPECT_EQ("'/*' ^~ '*/'"_rx.match(comment).index(), comment.size());
+}
+
+TEST(Regex, Lookahead) {
+  // Nested lookaheads are submitted once per index by the sub-searches sharing the match
+  std::string a(512, 'a');
+  EXPECT_EQ("{!{^* /{'a'* 'b'}}}+"_rx.match(a).index(), a.size());
+  EXPECT_EQ("{!{^* /{'a'* 'b'}}}+"_rx.match(a + 'b').index(), npos());
+  EXPECT_EQ("{!{'a' /{'a'* 'b'}}}+"_rx.match("baaa").index(), 4);
+  EXPECT_EQ("{^ /{!{'a'* 'b'}}}+"_rx.match("aaa").index(), 2);
+}
+
+TEST(Regex, Edges) {
+  // Each nested loop adds an edge to the leaf, spilling the inline edges
+  Regex regex = "{'y'? {'x'? 'a'+}+}+";
+  size_t breadth = 0;
+
+  for (const Node *node : regex.members()) {
+    const Edges &edges = node->edges();
+    breadth = std::max(breadth, edges.size());
+    EXPECT_TRUE(std::is_sorted(edges.begin(), edges.end(), [](const Node *a, const Node *b) {
+      return a->index() <= b->index();
+    }));
+  }
+
+  EXPECT_GT(breadth, EDGES_INLINE);
+  EXPECT_EQ(regex.members().size(), regex.stack().size());
+  EXPECT_EQ(regex.match("aaxayaxa").index(), 8);
+  EXPECT_EQ(regex.match("yxaab").index(), 4);
+  EXPECT_FALSE(regex.match("yx"));
+}
+
+TEST(Regex, Stack) {
+  // Nodes are sized after the parse, without any fixed capacity
+  EXPECT_EQ("'x'"_rx.stack().size(), 1);
+  EXPECT_EQ(Regex{""}.stack().size(), 0);
+
+  std::string src{};
+  std::string expr{};
+
+  for (size_t n = 0; n < 256; n++) {
+    src += fmt::format("{}'k{:03}'", n ? "|" : "", n);
+    expr = fmt::format("k{:03}", n);
+  }
+
+  Regex regex{src};
+  EXPECT_GT(regex.stack().size(), 256);
+  EXPECT_EQ(regex.members().size(), regex.stack().size());
+  EXPECT_EQ(regex.match(expr).index(), expr.size());
+  EXPECT_EQ(regex.match("k128").index(), 4);
+  EXPECT_FALSE(regex.match("x"));
+
+  auto stack = regex.stack();
+  for (const Node &node : stack) {
+    for (const Node *edge : node.edges()) {
+      EXPECT_TRUE(stack.data() <= edge and edge < stack.data() + stack.size());
+    }
+  }
+}
+
+TEST(Regex, Static) {
+  constexpr const auto &wave = "'/*' ^~ '*/'"_srx;
+  static_assert(wave.stack().size() == 5);
+  static_assert(wave.head() == &wave.stack()[0]);
+
+  static constexpr Regex view{wave};
+  Regex regex{wave.src()};
+  EXPECT_EQ(view.stack().size(), regex.stack().size());
+
+  for (size_t n = 0; n < view.members().size(); n++) {
+    const Node *a = view.members()[n];
+    const Node *b = regex.members()[n];
+    EXPECT_EQ(a->index(), b->index());
+    EXPECT_EQ(a->state().option(), b->state().option());
+    EXPECT_EQ(a->breadth(), b->breadth());
+  }
+
+  EXPECT_EQ(view.match("/* comment */ x").index(), 13);
+  EXPECT_FALSE(view.match("/* comment"));
+  EXPECT_EQ("{'a'|'b'}+ n"_srx.stack().size(), "{'a'|'b'}+ n"_rx.stack().size());
+}
+
+TEST(Regex, Dfa) {
+  EXPECT_DFA("'abc'", "abc", "abcccc", "ab", "cba", "");
+  EXPECT_DFA("[0-9]+", "0123456789", "01a", "a", "");
+  EXPECT_DFA("{'abc'}*", "abcabcab", "", "ab");
+  EXPECT_DFA("{'abc'}?", "abc", "", "ab");
+  EXPECT_DFA("{'ab'n}+", "ab1ab2ab3", "ab1ab", "ab");
+  EXPECT_DFA("{'a'|'ab'} 'c'", "abc", "ac", "ab");
+  EXPECT_DFA("a{a|'_'|n}*", "snake_case_variable123 ", "_", "a");
+  EXPECT_DFA("^~'c'", "abc", "ab", "cc");
+  EXPECT_DFA("'//' {a|' '} ~ '//'", "// The program starts here // int main() {", "// a");
+  EXPECT_DFA("n ~ {'z'|'9'}", "0123456789", "012345678z", "01a9");
+  EXPECT_DFA("{' '} ~ 'sus'", "      sus  ", "    |   sus ");
+  EXPECT_DFA(quoted(LOREM_IPSUM), LOREM_IPSUM, LOREM_IPSUM.substr(1));
+
+  // Lookaheads depending on the next character only
+  EXPECT_DFA("'int' /!a", "int", "int ", "int_", "integer", "in");
+  EXPECT_DFA("'L'? Q {{{'\\'^}|^} ~ /{Q|'\n'}} ? {Q|'\n'}", R"("a\"b" c)", "\"abc\n", "\"abc");
+  EXPECT_DFA("'//' {{{'\\'^}|^} ~ /'\n'}? /'\n'", "// comment\n", "//\n", "// \\\n a\n", "// a");
+  EXPECT_DFA("'/*' ^~ '*/'", "/* comment */ a */", "/* unterminated", "/*/");
+  EXPECT_DFA("{^~/_}", "abc def", "abc");
+
+  // Lookaheads past the next character falls back to the backtracking engine
+  Regex regex{"'a' /'bc'"};
+  Dfa dfa{regex};
+  EXPECT_FALSE(dfa.compiled());
+  EXPECT_EQ(dfa.match("abc").view(), "a"sv);
+  EXPECT_FALSE(dfa.match("abd"));
+}
+
 }  // namespace mcc::regex
 
 #endif